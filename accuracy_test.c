@@ -1,7 +1,17 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include "ace_eval.h"
+#include "ace_enum.h"
+#ifdef ACE_DENSE
+#include "ace_dense.h"
+#endif
 
-#define NCARDS 7
+#ifndef NCARDS
+#define NCARDS 7  //build with -DNCARDS=5 or 6 to test the smaller hands
+#endif
+//build with -DACE_SUITS to visit one hand per suit pattern, weighted, instead of every hand
 
 // Derived from 'allfive.c' by Kevin Suffecool
 // http://suffecool.net/poker/code/allfive.c
@@ -67,8 +77,103 @@ void verify(int a,int b, int c, int d, int e, int f, int g, Card xr)
   else printf("Error: %x != %x\n",ar,xr);
 }
 
+//take each card back out of a 7 card hand, and check it matches the hand built without it
+void verify_remove(int a,int b, int c, int d, int e, int f, int g)
+{
+  int cards[7]={a,b,c,d,e,f,g};
+  Card h[5]={0};
+  int i,j,ok=1;
+  for (i=0;i<7;i++) ACE_addcard(h,ACE_makecard(cards[i]));
+  for (i=0;i<7;i++) {
+	 Card r[5]={0};
+	 for (j=0;j<7;j++) if (j!=i) ACE_addcard(r,ACE_makecard(cards[j]));
+	 ACE_removecard(h,ACE_makecard(cards[i]));
+	 ok &= !memcmp(h,r,sizeof(r));
+	 ACE_addcard(h,ACE_makecard(cards[i]));
+  }
+  if (ok) { printf ("ok.."); }
+  else printf("Error: removing from %d %d %d %d %d %d %d\n",a,b,c,d,e,f,g);
+}
+
+#ifdef ACE_BATCH
+//E_board against E for every hole-card pair on one board
+void verify_board(int a,int b, int c, int d, int e)
+{
+  int cards[5]={a,b,c,d,e};
+  Card board[5]={0},out[ACE_COMBOS];
+  int i,x,y,errors=0;
+  for (i=0;i<5;i++) ACE_addcard(board,ACE_makecard(cards[i]));
+  E_board(board,out);
+  for (y=1;y<52;y++)
+	 for (x=0;x<y;x++) {
+		Card h[5],want=0;
+		memcpy(h,board,sizeof(h));
+		for (i=0;i<5;i++) if (cards[i]==x || cards[i]==y) break;
+		if (i==5) {
+		  ACE_addcard(h,ACE_makecard(x));
+		  ACE_addcard(h,ACE_makecard(y));
+		  want=E(h);
+		}
+		errors += out[ACE_combo(x,y)]!=want;
+	 }
+  if (!errors) { printf ("ok.."); }
+  else printf("Error: %d combos on board %d %d %d %d %d\n",errors,a,b,c,d,e);
+}
+#endif
+
 #define hand_rank(r)       ((r)>>28)
 
+//Each enumeration thread counts hand types in its own tally
+#define BATCH 1024
+typedef struct {
+  Card freq[10];
+  Card visited;
+#ifdef ACE_BATCH
+  //Batch adapter: queue hands for E_batch, and check every result against E
+  Card batch[BATCH][ACEHAND];
+  int weight[BATCH];
+  int nbatch, mismatches;
+#endif
+#ifdef ACE_DENSE
+  //Dense adapter: check every class number maps back to the hand's value
+  Card classes[ACE_DENSE_CLASSES+1];
+  int wrong;
+#endif
+} tally_t;
+
+#ifdef ACE_BATCH
+void batch_flush(tally_t* t) {
+  Card r[BATCH];
+  int i;
+  E_batch(t->batch,r,t->nbatch);
+  for (i=0;i<t->nbatch;i++) {
+	 if (r[i]!=E(t->batch[i]) && t->mismatches++<10)
+		printf("Batch error: %x != %x\n",r[i],E(t->batch[i]));
+	 t->freq[hand_rank(r[i])]+=t->weight[i];
+  }
+  t->nbatch=0;
+}
+#endif
+
+void count_hand(void* acc, Card h[], const int cards[], int weight) {
+  tally_t* t=acc;
+  t->visited++;
+#ifdef ACE_BATCH
+  memcpy(t->batch[t->nbatch],h,sizeof(t->batch[0]));
+  t->weight[t->nbatch]=weight;
+  if (++t->nbatch==BATCH) batch_flush(t);
+#elif defined(ACE_DENSE)
+  Card r=ACE_evaluate(h);
+  int d=ACE_dense(r);
+  if (ACE_undense(d)!=r && t->wrong++<10)
+	 printf("Dense error: %x -> %d -> %x\n",r,d,ACE_undense(d));
+  t->classes[d]+=weight;
+  t->freq[hand_rank(r)]+=weight;
+#else
+  t->freq[hand_rank(ACE_evaluate(h))]+=weight;
+#endif
+}
+
 static char *value_str[] = {
   "High Card",
   "One Pair",
@@ -88,14 +193,25 @@ enum cn {
   c2C, c3C, c4C, c5C, c6C, c7C, c8C, c9C, cTC, cJC, cQC, cKC, cAC,
   c2D, c3D, c4D, c5D, c6D, c7D, c8D, c9D, cTD, cJD, cQD, cKD, cAD,
   c2S, c3S, c4S, c5S, c6S, c7S, c8S, c9S, cTS, cJS, cQS, cKS, cAS
-}
+};
 
-main()
+int main(int argc, char* argv[])
 {
-  Card deck[52], hand[7]={0}, freq[10]={0};
-  int a, b, c, d, e, j;
-  int y=0,z=-1;
+  Card deck[52], freq[10]={0};
+#ifndef ACE_SUITS
+  Card empty[ACEHAND]={0};
+#endif
+  int nthreads = argc>1 ? atoi(argv[1]) : ACE_ncpus();
+  tally_t* tally;
+  struct timespec start,end;
+  int t;
+#if defined(ACE_BATCH) || defined(ACE_DENSE)
+  int mismatches=0;
+#endif
   Card i;
+
+  if (nthreads<1) nthreads=1;
+  tally = calloc(nthreads, sizeof(tally_t));
   
   /* first verify some hands */
   printf("%s\n", ACE_makecard(c2H)==0x00000041?"OK":"ERR");
@@ -115,6 +231,7 @@ main()
   printf("%s\n", ACE_makecard(cKS)==0x10000008?"OK":"ERR");
   printf("%s\n", ACE_makecard(cAS)==0x40000008?"OK":"ERR");
 
+#if NCARDS==7
   //a kqjt 9876 5432
   //no hand
   verify(c2H,c3H,c4H,c5H,cTD,cJD,cKD, 0<<28|0x0000<<13|0x0B0C); 
@@ -150,51 +267,66 @@ main()
   verify(cAD,c2H,c3H,cJD,cKD,cQD,cTD, 9<<28|0x1000<<13|0x0000); 
   verify(c9D,c7D,c8D,cJD,cKD,cQD,cTD, 9<<28|0x0800<<13|0x0000); 
   printf("\n");
+#endif
+
+  //removing cards
+  verify_remove(c2H,c3H,c4H,c5H,cTD,cJD,cKD);
+  verify_remove(cKD,c3H,c3C,c5H,c5S,c2D,cKS);
+  verify_remove(c3D,c9D,c9H,c3H,c9S,c3C,cTD);
+  verify_remove(c3D,c9D,c9H,c3H,c3S,c3C,cTD);
+  verify_remove(c9D,c7D,c8D,cJD,cKD,cQD,cTD);
+  verify_remove(c2S,c3S,c4S,c5S,c6S,c7S,c8S);
+  printf("\n");
+#ifdef ACE_BATCH
+  verify_board(c2H,c7D,c9S,cJC,cKH);
+  verify_board(c2H,c3H,c4H,cTH,cKH);
+  verify_board(c9D,c9H,c9S,c3C,c3D);
+  verify_board(cAS,cKS,cQS,cJS,cTS);
+  verify_board(c5C,c5D,c6H,c6S,c2C);
+  printf("\n");
+#endif
 
   // initialize the deck
   init_deck( deck );
   
-#if NCARDS == 7
-  // loop over every possible seven-card hand
-  for(y=0;y<46;y++)
-  {
-	 hand[5] = deck[y];
-#if NCARDS >= 6 
-    for(z=y+1;z<47;z++)
-    {
-		hand[6] = deck[z];
-#if NCARDS >= 5
-
-		//loop over every possible 5 card hand
-		for(a=z+1;a<48;a++)
-		{
-		  hand[0] = deck[a];
-		  for(b=a+1;b<49;b++)
-		  {
-			 hand[1] = deck[b];
-			 for(c=b+1;c<50;c++)
-			 {
-				hand[2] = deck[c];
-				for(d=c+1;d<51;d++)
-				{
-				  hand[3] = deck[d];
-				  for(e=d+1;e<52;e++)
-				  {
-					 hand[4] = deck[e];
-				
-					 i = eval_hand( hand, NCARDS );
-					 j = hand_rank(i);
-					 freq[j]++;
-				  }
-				}
-			 }
-		  }
-		}
+  // loop over every possible NCARDS-card hand, on all cores
+  clock_gettime(CLOCK_MONOTONIC, &start);
+#ifdef ACE_SUITS
+  ACE_enumerate_suits( NCARDS, nthreads, count_hand, tally, sizeof(tally_t) );
+#else
+  ACE_enumerate( deck, 52, empty, NCARDS, nthreads, count_hand, tally, sizeof(tally_t) );
+#endif
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  for(t=0;t<nthreads;t++) {
+#ifdef ACE_BATCH
+	 batch_flush( &tally[t] );
+	 mismatches += tally[t].mismatches;
 #endif
-    }
+	 for(i=0;i<=9;i++)
+		freq[i] += tally[t].freq[i];
+  }
+#ifdef ACE_BATCH
+  printf( "Batch mismatches: %d\n", mismatches );
 #endif
+#ifdef ACE_DENSE
+  {
+	 int d,classes=0;
+	 for(d=1;d<=ACE_DENSE_CLASSES;d++) {
+		Card n=0;
+		for(t=0;t<nthreads;t++) n+=tally[t].classes[d];
+		classes+=n>0;
+	 }
+	 for(t=0;t<nthreads;t++) mismatches+=tally[t].wrong;
+	 printf( "Dense classes: %d of %d, %d mismatches\n", classes, ACE_DENSE_CLASSES, mismatches );
   }
 #endif
+#ifdef ACE_SUITS
+  for(i=0,t=0;t<nthreads;t++) i+=tally[t].visited;
+  printf( "%u suit patterns\n", i );
+#endif
+  printf( "%d threads, %.3f seconds\n", nthreads,
+			 end.tv_sec-start.tv_sec + (end.tv_nsec-start.tv_nsec)/1e9 );
   for(i=0;i<=9;i++)
 	 printf( "%15s: %8d\n", value_str[i], freq[i]);
 
@@ -217,4 +349,33 @@ Three of a Kind:  6461620
 
 see: https://en.wikipedia.org/wiki/Poker_probability#Frequency_of_7-card_poker_hands
 
+For 5 cards (test_n5):
+      High Card:  1302540
+       One Pair:  1098240
+       Two Pair:   123552
+Three of a Kind:    54912
+       Straight:    10200
+          Flush:     5108
+     Full House:     3744
+ Four of a Kind:      624
+ Straight Flush:       40
+
+For 6 cards (test_n6):
+      High Card:  6612900
+       One Pair:  9730740
+       Two Pair:  2532816
+Three of a Kind:   732160
+       Straight:   361620
+          Flush:   205792
+     Full House:   165984
+ Four of a Kind:    14664
+ Straight Flush:     1844
+
+test_suits, test_suits5 and test_suits6 print the same counts from one hand per
+suit pattern, 6009159, 134459 and 962988 of them, and the number of patterns.
+
+test_dense also prints
+Dense classes: 4824 of 7462, 0 mismatches
+since the best 5 of 7 cards can never be one of the other 2638 classes (7-5-4-3-2 for one).
+
 */
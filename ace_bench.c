@@ -0,0 +1,381 @@
+/* One benchmark for all the evaluators.
+   usage: bench [-n hands] [-r runs] [-x kbytes] [-c] [variant ...]
+
+   `make bench` compiles each ace_eval_*.c with its symbols renamed (E_golf, E_base, ...),
+   so they all link into one program and run on the same hands.
+   There is one set of random 7 card hands, and one set for each hand type,
+   so a slower detector shows up in its own row instead of being averaged away.
+
+   Each variant runs on each set `runs` times, and the runs are interleaved
+   so a slow stretch of the machine is spread over all of them.  Reported:
+     ns/hand      the mean, from CLOCK_MONOTONIC
+     cycles/hand  the mean, from rdtsc.  The TSC ticks at a fixed rate, not the core clock,
+                  so with turbo this is time in units of the nominal clock.
+     Mhps         the mean, and the half width of its 95% confidence interval.
+   and from the cpu's own counters (perf_event_open, user space only), where there are any:
+     IPC          instructions per core cycle
+     br-miss      mispredicted branches per hand, and per 100 branches
+     L1D-miss     L1 data cache read misses per hand
+     MITE         uops per hand that came from the legacy decoders instead of the uop cache
+                  (Intel; on AMD, ops from the decoders instead of the op cache)
+   Counters the kernel or the cpu won't give (containers, VMs, perf_event_paranoid>2)
+   are reported as `-`, and the rest of the numbers are unaffected.
+   Every variant's values are summed and checked against decompress; a `!` marks a mismatch.
+   Name variants on the command line to run only those.  `-c` prints CSV instead of tables.
+   `-x kbytes` reads that much other memory before every EVICT hands, as a caller with its
+   own working set would, so a variant's tables are cold: 48 or so pushes them out of L1,
+   a few MB out of L2.  Only the hands are timed, each EVICT on their own, but the counters
+   run throughout and count the eviction reads too.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CYCLES() (_mm_lfence(),__rdtsc())
+#else
+#define CYCLES() 0ULL
+#endif
+#include "ace_eval.h"
+
+#define SCALAR(v) extern Card E_##v(Card []);
+#define BATCH(v)  extern void E_batch_##v(const Card [][ACEHAND], Card [], size_t);
+SCALAR(golf) SCALAR(base) SCALAR(unroll) SCALAR(flushtable)
+SCALAR(decompress) SCALAR(branchless) SCALAR(n) SCALAR(hybrid)
+BATCH(avx2) BATCH(avx512)
+extern const char* E_compress_decompress(void);
+
+#define CHUNK 1024  //hands per E_batch call
+#define EVICT 64    //hands between reads of the eviction buffer
+
+typedef struct {
+  const char *name;
+  Card (*eval)(Card []);
+  void (*batch)(const Card [][ACEHAND], Card [], size_t);
+  int needs;  //cpu feature
+} variant_t;
+enum {ANY, AVX2, AVX512};
+
+static const variant_t variants[]={
+  {.name="golf", .eval=E_golf},
+  {.name="base", .eval=E_base},
+  {.name="unroll", .eval=E_unroll},
+  {.name="flushtable", .eval=E_flushtable},
+  {.name="decompress", .eval=E_decompress},
+  {.name="branchless", .eval=E_branchless},
+  {.name="n", .eval=E_n},
+  {.name="hybrid", .eval=E_hybrid},
+  {.name="batch", .batch=E_batch_avx2, .needs=AVX2},
+  {.name="batch512", .batch=E_batch_avx512, .needs=AVX512},
+};
+#define NVARIANTS (int)(sizeof(variants)/sizeof(variants[0]))
+
+static const char *setnames[]={"random","High Card","Pair","Two Pair","Three of a Kind",
+  "Straight","Flush","Full House","Four of a Kind",NULL,"Straight Flush"};
+#define NSETS 11  //random, then rank+1
+
+/* Hardware counters, each opened on its own so one missing doesn't take the others*/
+enum {CYC, INS, BRANCH, BRMISS, L1D, MITE, NCOUNTERS};
+static const char *counternames[NCOUNTERS]={
+  "cycles","instructions","branches","branch-misses","L1D-misses","MITE-uops"};
+static int counters[NCOUNTERS];  //fd, or -1
+
+#ifdef __linux__
+static int opencounter(uint32_t type, uint64_t config){
+  struct perf_event_attr a;
+  memset(&a,0,sizeof(a));
+  a.size=sizeof(a);
+  a.type=type;
+  a.config=config;
+  a.disabled=1;
+  a.exclude_kernel=1;
+  a.exclude_hv=1;
+  a.read_format=PERF_FORMAT_TOTAL_TIME_ENABLED|PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return syscall(SYS_perf_event_open,&a,0,-1,-1,0);
+}
+
+static void opencounters(void){
+  int k;
+  counters[CYC]=opencounter(PERF_TYPE_HARDWARE,PERF_COUNT_HW_CPU_CYCLES);
+  counters[INS]=opencounter(PERF_TYPE_HARDWARE,PERF_COUNT_HW_INSTRUCTIONS);
+  counters[BRANCH]=opencounter(PERF_TYPE_HARDWARE,PERF_COUNT_HW_BRANCH_INSTRUCTIONS);
+  counters[BRMISS]=opencounter(PERF_TYPE_HARDWARE,PERF_COUNT_HW_BRANCH_MISSES);
+  counters[L1D]=opencounter(PERF_TYPE_HW_CACHE,PERF_COUNT_HW_CACHE_L1D
+									 |PERF_COUNT_HW_CACHE_OP_READ<<8|PERF_COUNT_HW_CACHE_RESULT_MISS<<16);
+  //there is no generic uop cache event, so these are raw: umask<<8|event
+  counters[MITE]=-1;
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_is("intel"))
+	 counters[MITE]=opencounter(PERF_TYPE_RAW,0x0479);  //IDQ.MITE_UOPS
+  else if (__builtin_cpu_is("amd"))
+	 counters[MITE]=opencounter(PERF_TYPE_RAW,0x01AA);  //de_src_op_disp.x86_decoder, Zen
+#endif
+  for (k=0;k<NCOUNTERS;k++)
+	 if (counters[k]<0) counters[k]=-1;
+}
+
+static void startcounters(void){
+  int k;
+  for (k=0;k<NCOUNTERS;k++)
+	 if (counters[k]>=0) {
+		ioctl(counters[k],PERF_EVENT_IOC_RESET,0);
+		ioctl(counters[k],PERF_EVENT_IOC_ENABLE,0);
+	 }
+}
+
+/* Adds each count, scaled up if the counter was multiplexed*/
+static void stopcounters(double sum[NCOUNTERS]){
+  uint64_t v[3];
+  int k;
+  for (k=0;k<NCOUNTERS;k++)
+	 if (counters[k]>=0) ioctl(counters[k],PERF_EVENT_IOC_DISABLE,0);
+  for (k=0;k<NCOUNTERS;k++)
+	 if (counters[k]>=0 && read(counters[k],v,sizeof(v))==sizeof(v) && v[2])
+		sum[k]+=(double)v[0]*v[1]/v[2];
+}
+#else
+static void opencounters(void){ int k; for (k=0;k<NCOUNTERS;k++) counters[k]=-1; }
+static void startcounters(void){}
+static void stopcounters(double sum[NCOUNTERS]){}
+#endif
+
+typedef struct {
+  double ns,cycles,mhps,mhps2;  //sums over runs
+  double count[NCOUNTERS];
+  Card check;
+} result_t;
+
+double seconds(void){
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC,&t);
+  return t.tv_sec+t.tv_nsec/1e9;
+}
+
+static uint64_t seed=88172645463325252ULL;
+static int rnd(int n){
+  seed^=seed<<13; seed^=seed>>7; seed^=seed<<17;
+  return (seed>>32)*n>>32;
+}
+
+/* Deal 7 cards: the first `nfixed` are given, the rest are random.*/
+static void deal(Card h[ACEHAND], const int fixed[], int nfixed){
+  uint64_t used=0;
+  int k,c;
+  memset(h,0,ACEHAND*sizeof(Card));
+  for (k=0;k<7;k++) {
+	 if (k<nfixed) c=fixed[k];
+	 else do c=rnd(52); while (used>>c&1);
+	 used|=1ULL<<c;
+	 ACE_addcard(h,ACE_makecard(c));
+  }
+}
+
+/* Fill a set with hands of one type (rank -1 for any), checked with E_decompress.
+   Straight flushes and quads are too rare to wait for, so they are built around
+   a random straight flush or four of a kind.
+   Returns the sum of the values, to check the variants against.*/
+static Card fill(Card (*h)[ACEHAND], long n, int rank){
+  int fixed[5],k;
+  long i=0;
+  Card v,sum=0;
+  while (i<n) {
+	 int s=rnd(4), r=rnd(13);
+	 if (rank==9) {
+		r=3+rnd(10);  //top card, Five to Ace
+		for (k=0;k<5;k++) fixed[k]=s*13+(r-k+13)%13;
+		deal(h[i],fixed,5);
+	 }
+	 else if (rank==7) {
+		for (k=0;k<4;k++) fixed[k]=k*13+r;
+		deal(h[i],fixed,4);
+	 }
+	 else
+		deal(h[i],fixed,0);
+	 v=E_decompress(h[i]);
+	 if (rank<0 || (int)ACE_rank(v)==rank) i++,sum+=v;
+  }
+  return sum;
+}
+
+static const char *evict;
+static long evictsize;
+static volatile char evictsum;
+
+/* Read every line of the eviction buffer*/
+static void pollute(void){
+  char sum=0;
+  long i;
+  for (i=0;i<evictsize;i+=64)
+	 sum+=evict[i];
+  evictsum=sum;
+}
+
+/* Evaluate hands [i,end), the part that is timed*/
+static void part(const variant_t *v, Card (*h)[ACEHAND], Card *out, long i, long end){
+  if (v->batch)
+	 v->batch((const Card (*)[ACEHAND])h+i,out+i,end-i);
+  else
+	 for (;i<end;i++)
+		out[i]=v->eval(h[i]);
+}
+
+static void run(const variant_t *v, Card (*h)[ACEHAND], Card *out, long n, result_t *r){
+  double t=0, t0;
+  uint64_t c=0, c0;
+  long i,step=evictsize ? EVICT : CHUNK;
+  startcounters();
+  if (!evictsize) {
+	 t0=seconds();
+	 c0=CYCLES();
+  }
+  for (i=0;i<n;i+=step) {
+	 if (evictsize) {  //time each part on its own, without the eviction
+		pollute();
+		t0=seconds();
+		c0=CYCLES();
+	 }
+	 part(v,h,out,i,n-i<step ? n : i+step);
+	 if (evictsize) {
+		c+=CYCLES()-c0;
+		t+=seconds()-t0;
+	 }
+  }
+  if (!evictsize) {
+	 c=CYCLES()-c0;
+	 t=seconds()-t0;
+  }
+  stopcounters(r->count);
+  r->ns+=t*1e9/n;
+  r->cycles+=(double)c/n;
+  r->mhps+=n/t/1e6;
+  r->mhps2+=(n/t/1e6)*(n/t/1e6);
+  for (r->check=0,i=0;i<n;i++)
+	 r->check+=out[i];
+}
+
+/* Two sided 95% point of Student's t with `df` degrees of freedom*/
+static double t95(int df){
+  static const double t[]={0,12.71,4.303,3.182,2.776,2.571,2.447,2.365,2.306,2.262,2.228};
+  double z=1.96;
+  if (df<=10) return t[df];
+  return z+(z*z*z+z)/(4*df)+(5*pow(z,5)+16*z*z*z+3*z)/(96.0*df*df);
+}
+
+/* num/den into `out`, or a `-` (nothing in CSV) for a counter we don't have*/
+static void stat(char out[16], int have, double num, double den, int width, int prec, int csv){
+  if (!have || den<=0)
+	 snprintf(out,16,"%*s",csv ? 0 : width,csv ? "" : "-");
+  else
+	 snprintf(out,16,"%*.*f",csv ? 0 : width,prec,num/den);
+}
+
+/* Runs here, and named (or nothing was named)*/
+static int wanted(const variant_t *v, char *names[], int nnames){
+  int a;
+  __builtin_cpu_init();
+  if (v->needs==AVX2 && !__builtin_cpu_supports("avx2")) return 0;
+  if (v->needs==AVX512 && !__builtin_cpu_supports("avx512f")) return 0;
+  for (a=0;a<nnames;a++)
+	 if (!strcmp(names[a],v->name)) return 1;
+  return !nnames;
+}
+
+int main(int argc, char* argv[])
+{
+  long n=1<<20;
+  int runs=10, csv=0, a, s, k, r, on[NVARIANTS], nnames=0;
+  char *names[64];
+  Card (*sets[NSETS])[ACEHAND], *out, check[NSETS];
+  static result_t res[NVARIANTS][NSETS];
+
+  for (a=1;a<argc;a++)
+	 if (!strcmp(argv[a],"-n") && a+1<argc) n=atol(argv[++a]);
+	 else if (!strcmp(argv[a],"-r") && a+1<argc) runs=atoi(argv[++a]);
+	 else if (!strcmp(argv[a],"-x") && a+1<argc) evictsize=atol(argv[++a])*1024;
+	 else if (!strcmp(argv[a],"-c")) csv=1;
+	 else if (argv[a][0]!='-' && nnames<64) names[nnames++]=argv[a];
+	 else {
+		fprintf(stderr,"usage: bench [-n hands] [-r runs] [-x kbytes] [-c] [variant ...]\n");
+		return 1;
+	 }
+  if (n<1 || runs<2 || evictsize<0) {
+	 fprintf(stderr,"need at least 1 hand and 2 runs\n");
+	 return 1;
+  }
+  if (evictsize) {
+	 char *buf=malloc(evictsize);
+	 if (!buf) {
+		fprintf(stderr,"out of memory\n");
+		return 1;
+	 }
+	 memset(buf,1,evictsize);  //not zero: untouched pages all read the one zero page
+	 evict=buf;
+  }
+  for (k=0;k<NVARIANTS;k++)
+	 on[k]=wanted(&variants[k],names,nnames);
+
+  out=malloc(n*sizeof(Card));
+  for (s=0;s<NSETS;s++) {
+	 sets[s]=NULL;
+	 if (s && !setnames[s]) continue;
+	 if (!(sets[s]=malloc(n*sizeof(*sets[s]))) || !out) {
+		fprintf(stderr,"out of memory\n");
+		return 1;
+	 }
+	 check[s]=fill(sets[s],n,s-1);
+  }
+  opencounters();
+  if (csv)
+	 printf("set,variant,ns,tsc_cycles,mhps,mhps_ci95,ipc,branch_misses,miss_pct,l1d_misses,mite_uops,ok\n");
+  else {
+	 printf("%ld hands per set, %d runs, E_decompress uses %s\n",n,runs,E_compress_decompress());
+	 if (evictsize)
+		printf("%ldK read before every %d hands\n",evictsize/1024,EVICT);
+	 printf("counters:");
+	 for (k=0;k<NCOUNTERS;k++)
+		printf(" %s%s",counternames[k],counters[k]<0 ? " (unavailable)" : "");
+	 printf("\n");
+  }
+
+  for (r=0;r<runs;r++)
+	 for (s=0;s<NSETS;s++)
+		if (sets[s])
+		  for (k=0;k<NVARIANTS;k++)
+			 if (on[k])
+				run(&variants[k],sets[s],out,n,&res[k][s]);
+
+  for (s=0;s<NSETS;s++) {
+	 if (!sets[s]) continue;
+	 if (!csv)
+		printf("\n%s\n%-12s %9s %12s %9s %8s %6s %8s %6s %9s %7s\n",setnames[s],"variant","ns/hand",
+				 "cycles/hand","Mhps","+-95%","IPC","br-miss","%miss","L1D-miss","MITE");
+	 for (k=0;k<NVARIANTS;k++) {
+		result_t *x=&res[k][s];
+		double mean=x->mhps/runs, var=(x->mhps2-runs*mean*mean)/(runs-1), hands=(double)n*runs;
+		double ci=t95(runs-1)*sqrt(var>0 ? var : 0)/sqrt(runs);
+		char ipc[16],brmiss[16],pct[16],l1d[16],mite[16];
+		if (!on[k]) continue;
+		stat(ipc,counters[CYC]>=0 && counters[INS]>=0,x->count[INS],x->count[CYC],6,2,csv);
+		stat(brmiss,counters[BRMISS]>=0,x->count[BRMISS],hands,8,3,csv);
+		stat(pct,counters[BRMISS]>=0 && counters[BRANCH]>=0,100*x->count[BRMISS],x->count[BRANCH],6,2,csv);
+		stat(l1d,counters[L1D]>=0,x->count[L1D],hands,9,3,csv);
+		stat(mite,counters[MITE]>=0,x->count[MITE],hands,7,2,csv);
+		if (csv)
+		  printf("%s,%s,%.3f,%.2f,%.2f,%.2f,%s,%s,%s,%s,%s,%d\n",setnames[s],variants[k].name,
+					x->ns/runs,x->cycles/runs,mean,ci,ipc,brmiss,pct,l1d,mite,x->check==check[s]);
+		else
+		  printf("%-12s %9.2f %12.1f %9.1f %8.1f %s %s %s %s %s %s\n",variants[k].name,
+					x->ns/runs,x->cycles/runs,mean,ci,ipc,brmiss,pct,l1d,mite,x->check==check[s] ? "" : "!");
+	 }
+  }
+  return 0;
+}
@@ -0,0 +1,59 @@
+/* Dense hand strength tables.
+   See ace_dense.h
+*/
+#include "ace_dense.h"
+
+uint16_t ACE_colex[8192];
+static Card undense[ACE_DENSE_CLASSES+1];
+
+/* First class number of each hand type, and how many kicker sets go with each value set.
+   High card 1277, pair 13*220, two pair 78*11, trips 13*66, straight 10,
+   flush 1277, full house 13*12, quads 13*12, straight flush 10.
+   A straight's one value card numbers 3 (the 5) to 12 (the ace), so those bases are 3 less. */
+const uint16_t ACE_dense_base[10]   ={1,1278,4138,4996,5851,5864,7141,7297,0,7450};
+const uint16_t ACE_dense_kickers[10]={1, 220,  11,  66,   1,   1,  12,  12,0,   1};
+
+//how many value and kicker cards each hand type has
+static const int nvalue[10] ={0,1,2,1,1,5,1,1,0,1};
+static const int nkicker[10]={5,3,1,2,0,0,1,1,0,0};
+
+static int straight(Card m){
+  return m==0x100F || (m&m>>1&m>>2&m>>3&m>>4);  //A-5, or 5 in a row
+}
+
+__attribute__((constructor))
+static void build_dense(void){
+  int count[14]={0}, n5=0;
+  Card m,v,k,free,rank;
+
+  //ascending masks with the same number of bits are in poker order, highest card first
+  for (m=0;m<8192;m++) {
+	 ACE_colex[m]=count[__builtin_popcount(m)]++;
+	 if (__builtin_popcount(m)==5)
+		ACE_colex[m]=straight(m) ? 0 : n5++;
+  }
+
+  //walk every value set and every kicker set among the other ranks
+  for (rank=0;rank<10;rank++) {
+	 if (rank==8) continue;
+	 for (v=0;v<8192;v++) {
+		if (__builtin_popcount(v)!=nvalue[rank]) continue;
+		if (rank==5 && straight(v)) continue;
+		if (rank==4 || rank==9) {
+		  if (v<8) continue;  //5 high is the lowest straight
+		  undense[ACE_dense(rank<<28|v<<13)]=rank<<28|v<<13;
+		  continue;
+		}
+		free=8191&~v;
+		for (k=free;;k=(k-1)&free) {  //every subset of the free ranks
+		  if (__builtin_popcount(k)==nkicker[rank] && !(rank==0 && straight(k)))
+			 undense[ACE_dense(rank<<28|v<<13|k)]=rank<<28|v<<13|k;
+		  if (!k) break;
+		}
+	 }
+  }
+}
+
+Card ACE_undense(int d){
+  return d>0 && d<=ACE_DENSE_CLASSES ? undense[d] : 0;
+}
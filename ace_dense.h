@@ -0,0 +1,40 @@
+/* Dense hand strength: the 7462 distinct poker hands, numbered 1 (7-5-4-3-2) to 7462 (royal flush).
+ *
+ * `E` packs the hand type and two 13-bit rank masks (value and kicker cards) into 32 bits.
+ * That orders hands correctly but is too sparse to index an array.
+ * ACE_dense maps it to a 16 bit class number in the same order, so results can be stored
+ * in half the space, counted in a 7463 entry array, or sorted with a counting sort.
+ * ACE_undense goes back to the `E` value, so ACE_rank and the masks can be read from it.
+ *
+ * Within a hand type the value cards are ranked first, then the kicker cards among the
+ * ranks that are left.  A set of k ranks is numbered by its place among all k-rank sets
+ * (the order of the 13 bit masks), from one 8K table built at startup.  The only 5-rank
+ * sets it sees are flushes and high cards, so those are numbered past the straights.
+ */
+#ifndef ACE_DENSE_H
+#define ACE_DENSE_H
+#include "ace_eval.h"
+
+#define ACE_DENSE_CLASSES 7462
+
+extern uint16_t ACE_colex[8192];  //place of a rank mask among the masks with as many bits
+extern const uint16_t ACE_dense_base[10], ACE_dense_kickers[10];
+
+//remove `bit` from x, moving the higher bits down one
+static inline Card ACE_squeeze(Card x, Card bit){ return (x&(bit-1))|((x>>1)&-bit); }
+
+/* No branches: with no value cards (high card) or no kickers (straight, flush) the
+   missing part numbers 0, and a squeeze by 0 changes nothing.*/
+static inline uint16_t ACE_dense(Card r){
+  Card value=(r>>13)&8191, kicker=r&8191;
+  Card low=value&-value, rest=ACE_squeeze(value^low,low);
+  //the kicker cards are ranked among the ranks that are not value cards (at most 2)
+  kicker=ACE_squeeze(ACE_squeeze(kicker,low),rest&-rest);
+  return ACE_dense_base[ACE_rank(r)]+ACE_colex[value]*ACE_dense_kickers[ACE_rank(r)]+ACE_colex[kicker];
+}
+
+//class number 1..7462 back to the `E` value
+extern Card ACE_undense(int d);
+
+#define ACE_evaluate_dense(h)  ACE_dense(E((h)))
+#endif
@@ -0,0 +1,88 @@
+/* Hand values to English.
+   See ace_describe.h
+*/
+#include <string.h>
+#include "ace_describe.h"
+
+static const char names[13][8]={
+  "Two","Three","Four","Five","Six","Seven","Eight","Nine","Ten","Jack","Queen","King","Ace"};
+static const char plurals[13][8]={
+  "Twos","Threes","Fours","Fives","Sixes","Sevens","Eights","Nines","Tens","Jacks","Queens","Kings","Aces"};
+static const unsigned char namelen[13]  ={3,5,4,4,3,5,5,4,3,4,5,4,3};
+static const unsigned char plurallen[13]={4,6,5,5,5,6,6,5,4,5,6,5,4};
+
+/* One phrase per hand type: \1 is the next card, \2 the next card in the plural,
+   \3 the next card after "a" or "an".  The value cards come first, then the kickers.*/
+static const char *phrases[10]={
+  "High Card, \1 with \1 \1 \1 \1",
+  "Pair, \2 over \1 \1 \1",
+  "2 Pair, \2 and \2 with \3",
+  "3 of a Kind, \2 over \1 \1",
+  "Straight, \1 high",
+  "Flush, \1 \1 \1 \1 \1",
+  "Full House, \2 over \2",
+  "4 of a Kind, \2 with \3",
+  "Error",
+  "Straight Flush, \1 high"
+};
+
+void ACE_decoder_init(ACE_decoder *d){
+  uint32_t m,o;
+  int r,n;
+  for (m=0;m<8192;m++) {
+	 for (o=0,n=0,r=12;r>=0;r--)
+		if (m>>r&1 && n<7)
+		  o|=r<<4*n++;
+	 d->order[m]=o|(uint32_t)n<<28;
+  }
+}
+
+size_t ACE_decode(const ACE_decoder *d, Card v, char out[ACE_DECODE_MAX]){
+  uint32_t value=d->order[(v>>13)&8191], kicker=d->order[v&8191];
+  //all the cards in order: up to 5 value cards, then the kickers
+  uint64_t cards=(value&0xFFFFFFF)|(uint64_t)(kicker&0xFFFFFFF)<<4*(value>>28);
+  int ncards=(value>>28)+(kicker>>28), r=ACE_rank(v);
+  const char *p=phrases[r<10 ? r : 8];
+  char *o=out;
+
+  for (;*p;p++) {
+	 if (*p>3) { *o++=*p; continue; }
+	 if (!ncards--) break;  //fewer cards than the phrase: stop
+	 r=cards&15;
+	 cards>>=4;
+	 if (*p==3) {  //a Queen, an Eight, an Ace
+		int an=(r==6 || r==12);
+		memcpy(o,an ? "an " : "a  ",4);
+		o+=2+an;
+	 }
+	 if (*p==2) { memcpy(o,plurals[r],8); o+=plurallen[r]; }
+	 else       { memcpy(o,names[r],8); o+=namelen[r]; }
+  }
+  return o-out;
+}
+
+void ACE_decode_fixed(const ACE_decoder *d, const Card v[], size_t n, char *out, size_t width){
+  char text[ACE_DECODE_MAX+8];
+  size_t i,len;
+  if (!width) return;
+  for (i=0;i<n;i++,out+=width) {
+	 len=ACE_decode(d,v[i],text);
+	 if (len>width-1) len=width-1;
+	 memcpy(out,text,len);
+	 memset(out+len,' ',width-1-len);
+	 out[width-1]='\n';
+  }
+}
+
+size_t ACE_decode_prefixed(const ACE_decoder *d, const Card v[], size_t n,
+									char *out, size_t size, size_t *used){
+  char *o=out;
+  size_t i,len;
+  for (i=0;i<n && size-(o-out)>=ACE_DECODE_MAX+1;i++) {
+	 len=ACE_decode(d,v[i],o+1);
+	 *o=len;
+	 o+=len+1;
+  }
+  if (used) *used=o-out;
+  return i;
+}
@@ -0,0 +1,34 @@
+/* Hand values to English, in bulk.
+ *
+ * The same phrases as ace_decode.c ("Full House, Kings over Twos"), written into the
+ * caller's buffer.  No stdio, no allocation, and no global state: the lookup tables
+ * live in an ACE_decoder that the caller sets up once with ACE_decoder_init, and that
+ * any number of threads can then share.
+ *
+ * For each 13 bit rank mask the decoder holds its ranks, highest first, so decoding is
+ * two lookups and a few memcpys of precomputed names.
+ */
+#ifndef ACE_DESCRIBE_H
+#define ACE_DESCRIBE_H
+#include "ace_eval.h"
+
+#define ACE_DECODE_MAX 64  //longest text, with room to spare
+
+typedef struct {
+  uint32_t order[8192];  //the ranks of a mask, highest first, 4 bits each; the count in the top 4
+} ACE_decoder;
+
+extern void ACE_decoder_init(ACE_decoder *d);
+
+/* One value, not terminated. Returns its length, at most ACE_DECODE_MAX*/
+extern size_t ACE_decode(const ACE_decoder *d, Card v, char out[ACE_DECODE_MAX]);
+
+/* n values into rows of `width` bytes: the text, cut to width-1, spaces, and a newline.
+   Writes n*width bytes*/
+extern void ACE_decode_fixed(const ACE_decoder *d, const Card v[], size_t n, char *out, size_t width);
+
+/* As many of the n values as fit in `size` bytes, each as a length byte then the text.
+   Returns how many were written, and the bytes used in *used*/
+extern size_t ACE_decode_prefixed(const ACE_decoder *d, const Card v[], size_t n,
+											 char *out, size_t size, size_t *used);
+#endif
@@ -0,0 +1,49 @@
+/* Picking the compressor when the program loads.
+ *
+ * With BMI2, `pext` gathers the 13 rank bits in a single instruction.
+ * It is picked once, when the program is loaded: the `ifunc` resolver checks the cpu
+ * and binds the evaluator to either version, so calls pay nothing for the choice.
+ * AMD before Zen3 runs `pext` in microcode, which is slower than DECOMPRESS2.
+ *
+ * For the evaluator files: define PEXT_DISPATCH (or don't, to always use DECOMPRESS2),
+ * include this once, and
+ *    ACE_EVALUATOR(name, soft, body, args...)
+ * defines `Card name(Card h[])` as body(h, args..., compress), with `compress_pext`
+ * or the `soft` compressor.  ACE_COMPRESS_NAME defines `E_compress`, which says which.
+ */
+#ifndef ACE_DISPATCH_H
+#define ACE_DISPATCH_H
+#include "ace_eval.h"
+
+#if defined(PEXT_DISPATCH) && defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+
+__attribute__((target("bmi2"),always_inline))
+static inline Card compress_pext(Card a){
+  return _pext_u32(a,0x55555540);
+}
+
+static int use_pext(void){
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("bmi2")
+	 && !__builtin_cpu_is("amdfam15h")
+	 && !__builtin_cpu_is("amdfam17h");
+}
+
+#define ACE_EVALUATOR(name,soft,body,...) \
+  __attribute__((target("bmi2"))) \
+  static Card name##_pext(Card h[]){ return body(h,##__VA_ARGS__,compress_pext); } \
+  static Card name##_soft(Card h[]){ return body(h,##__VA_ARGS__,soft); } \
+  static Card (*resolve_##name(void))(Card []){ return use_pext() ? name##_pext : name##_soft; } \
+  Card name(Card h[]) __attribute__((ifunc("resolve_" #name)));
+
+#define ACE_COMPRESS_NAME \
+  const char* E_compress(void){ return use_pext() ? "pext" : "decompress2"; }
+#else
+#define ACE_EVALUATOR(name,soft,body,...) \
+  Card name(Card h[]){ return body(h,##__VA_ARGS__,soft); }
+
+#define ACE_COMPRESS_NAME \
+  const char* E_compress(void){ return "decompress2"; }
+#endif
+#endif
@@ -0,0 +1,242 @@
+/* Exhaustive enumeration of hands, spread over threads.
+   See ace_enum.h
+*/
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "ace_enum.h"
+
+#define MAXCARDS 52
+
+typedef struct {
+  const Card *deck;
+  int ndeck, k;
+  Card base[ACEHAND];
+  ACE_visitor visit;
+  int njobs;
+  int jobs[MAXCARDS*(MAXCARDS-1)/2][2];  //first two deck positions of each job
+  volatile int next;                     //next job to take
+} enum_t;
+
+typedef struct {
+  enum_t *e;
+  void *acc;
+  int cards[MAXCARDS];
+} worker_t;
+
+/* Add one more card at each level, starting from deck position `start`.
+   The innermost level calls `visit` directly.
+*/
+static void walk(worker_t *w, const Card h[], int level, int start){
+  enum_t *e=w->e;
+  Card hand[ACEHAND];
+  int c;
+  if (level==e->k-1) {
+	 for (c=start;c<e->ndeck;c++) {
+		memcpy(hand,h,sizeof(hand));
+		ACE_addcard(hand,e->deck[c]);
+		w->cards[level]=c;
+		e->visit(w->acc,hand,w->cards,1);
+	 }
+	 return;
+  }
+  for (c=start;c<=e->ndeck-(e->k-level);c++) {
+	 memcpy(hand,h,sizeof(hand));
+	 ACE_addcard(hand,e->deck[c]);
+	 w->cards[level]=c;
+	 walk(w,hand,level+1,c+1);
+  }
+}
+
+static void* work(void *arg){
+  worker_t *w=arg;
+  enum_t *e=w->e;
+  Card hand[ACEHAND];
+  int j,i;
+  while ((j=__sync_fetch_and_add(&e->next,1)) < e->njobs) {
+	 memcpy(hand,e->base,sizeof(hand));
+	 for (i=0;i<e->k && i<2;i++) {
+		w->cards[i]=e->jobs[j][i];
+		ACE_addcard(hand,e->deck[w->cards[i]]);
+	 }
+	 if (e->k<=2)
+		e->visit(w->acc,hand,w->cards,1);
+	 else
+		walk(w,hand,2,w->cards[1]+1);
+  }
+  return NULL;
+}
+
+/* Run `fn` on `nthreads` workers, whose first member is set to point to the shared state.
+   Returns 0, or -1 if no thread started: any one thread finishes all the jobs.*/
+static int spawn(int nthreads, void *(*fn)(void *), void *workers, size_t size, void *shared){
+  pthread_t *threads=calloc(nthreads,sizeof(pthread_t));
+  int t,started;
+  if (!threads) return -1;
+  for (started=0;started<nthreads;started++) {
+	 *(void **)((char*)workers+started*size)=shared;
+	 if (pthread_create(&threads[started],NULL,fn,(char*)workers+started*size)) break;
+  }
+  for (t=0;t<started;t++)
+	 pthread_join(threads[t],NULL);
+  free(threads);
+  return started ? 0 : -1;
+}
+
+int ACE_enumerate(const Card deck[], int ndeck, const Card base[ACEHAND], int k,
+						int nthreads, ACE_visitor visit, void *accs, size_t accsize){
+  enum_t *e;
+  worker_t *w;
+  int y,z,t,ret=0;
+
+  if (k<0 || k>ndeck || ndeck>MAXCARDS) return -1;
+  if (nthreads<1) nthreads=1;
+  e=malloc(sizeof(enum_t));
+  w=calloc(nthreads,sizeof(worker_t));
+  if (!e || !w) { ret=-1; goto done; }
+
+  e->deck=deck;
+  e->ndeck=ndeck;
+  e->k=k;
+  memcpy(e->base,base,sizeof(e->base));
+  e->visit=visit;
+  e->next=0;
+
+/* The jobs are the choices of the first two cards (or first card, or none),
+   biggest first, so the small ones at the end fill in the gaps.*/
+  e->njobs=0;
+  if (k==0)
+	 e->njobs=1;
+  else if (k==1)
+	 for (y=0;y<ndeck;y++)
+		e->jobs[e->njobs++][0]=y;
+  else
+	 for (y=0;y<=ndeck-k;y++)
+		for (z=y+1;z<=ndeck-k+1;z++) {
+		  e->jobs[e->njobs][0]=y;
+		  e->jobs[e->njobs++][1]=z;
+		}
+
+  for (t=0;t<nthreads;t++)
+	 w[t].acc=(char*)accs+t*accsize;
+  ret=spawn(nthreads,work,w,sizeof(worker_t),e);
+ done:
+  free(w);
+  free(e);
+  return ret;
+}
+
+/* Suit-canonical enumeration.
+   A hand is its 4 suits' rank masks, and swapping suits doesn't change its value.
+   So only the hands whose masks are in order, suit 0 >= suit 1 >= suit 2 >= suit 3
+   as numbers, are visited; each stands for the 24 suit orders, less the ones that
+   swap equal masks (two empty suits, say), which give back the same hand.
+   Jobs are the club masks, biggest first.*/
+#define RANKMASKS 8192
+typedef struct {
+  int k;
+  ACE_visitor visit;
+  int nmasks[14];
+  uint16_t *masks[14];             //masks by number of cards, ascending, in `byrank`
+  uint16_t byrank[RANKMASKS];
+  int njobs;
+  uint16_t jobs[RANKMASKS];
+  volatile int next;
+} suits_t;
+
+typedef struct {
+  suits_t *e;
+  void *acc;
+  int cards[MAXCARDS];
+  Card mask[4];
+} suitworker_t;
+
+/* How many different hands the suit orders make of this one: 24/(n! for each n equal masks)*/
+static int weight(const Card m[4]){
+  static const int fact[]={1,1,2,6,24};
+  int i,run=1,w=24;
+  for (i=1;i<4;i++)
+	 if (m[i]==m[i-1]) run++;
+	 else w/=fact[run],run=1;
+  return w/fact[run];
+}
+
+/* Add the cards of `mask` in `suit` to h, and to the card list from `n`; returns the new count*/
+static int addsuit(Card h[ACEHAND], int cards[], int n, Card mask, int suit){
+  for (;mask;mask&=mask-1) {
+	 cards[n]=suit*13+__builtin_ctz(mask);
+	 ACE_addcard(h,ACE_makecard(cards[n]));
+	 n++;
+  }
+  return n;
+}
+
+/* Choose the mask of suit `suit`, no bigger than the one before, from the `left` cards still to deal*/
+static void suitwalk(suitworker_t *w, const Card h[ACEHAND], int suit, int n, int left){
+  suits_t *e=w->e;
+  Card hand[ACEHAND];
+  int p,i;
+  for (p = suit==3 ? left : 0; p<=left && p<=13; p++)
+	 for (i=0;i<e->nmasks[p] && e->masks[p][i]<=w->mask[suit-1];i++) {
+		w->mask[suit]=e->masks[p][i];
+		memcpy(hand,h,sizeof(hand));
+		addsuit(hand,w->cards,n,w->mask[suit],suit);
+		if (suit==3)
+		  e->visit(w->acc,hand,w->cards,weight(w->mask));
+		else
+		  suitwalk(w,hand,suit+1,n+p,left-p);
+	 }
+}
+
+static void* suitwork(void *arg){
+  suitworker_t *w=arg;
+  suits_t *e=w->e;
+  Card hand[ACEHAND];
+  int j,n;
+  while ((j=__sync_fetch_and_add(&e->next,1)) < e->njobs) {
+	 memset(hand,0,sizeof(hand));
+	 w->mask[0]=e->jobs[j];
+	 n=addsuit(hand,w->cards,0,w->mask[0],0);
+	 suitwalk(w,hand,1,n,e->k-n);
+  }
+  return NULL;
+}
+
+int ACE_enumerate_suits(int k, int nthreads, ACE_visitor visit, void *accs, size_t accsize){
+  suits_t *e;
+  suitworker_t *w;
+  int m,p,t,ret=0;
+
+  if (k<0 || k>52) return -1;
+  if (nthreads<1) nthreads=1;
+  e=calloc(1,sizeof(suits_t));
+  w=calloc(nthreads,sizeof(suitworker_t));
+  if (!e || !w) { ret=-1; goto done; }
+
+  e->k=k;
+  e->visit=visit;
+  for (p=0,m=0;p<=13;p++) {
+	 e->masks[p]=e->byrank+m;
+	 for (t=0;t<RANKMASKS;t++)
+		if (__builtin_popcount(t)==p) e->byrank[m++]=t;
+	 e->nmasks[p]=e->byrank+m-e->masks[p];
+  }
+  for (m=RANKMASKS;m-->0;)
+	 if (__builtin_popcount(m)<=k)
+		e->jobs[e->njobs++]=m;
+
+  for (t=0;t<nthreads;t++)
+	 w[t].acc=(char*)accs+t*accsize;
+  ret=spawn(nthreads,suitwork,w,sizeof(suitworker_t),e);
+
+ done:
+  free(w);
+  free(e);
+  return ret;
+}
+
+int ACE_ncpus(void){
+  long n=sysconf(_SC_NPROCESSORS_ONLN);
+  return n>0 ? n : 1;
+}
@@ -0,0 +1,30 @@
+/* Exhaustive enumeration of hands, spread over threads.
+ *
+ * ACE_enumerate visits every k-card subset of a deck, added on top of a `base` hand
+ * (all zeros for an empty one).  The partial hand is carried down the loops, so each
+ * hand costs a single ACE_addcard.
+ *
+ * The work is split into jobs by the first two cards, and the threads take jobs
+ * from a shared counter until there are none left, so fast threads do more of them.
+ * Each thread hands its own accumulator to `visit`: thread t gets
+ * (char*)accs + t*accsize.  Merge them when ACE_enumerate returns.
+ */
+#include "ace_eval.h"
+
+/* `h` is the hand, `cards` holds the k deck positions that were added to base.
+   `weight` is how many hands this one stands for: always 1 from ACE_enumerate.*/
+typedef void (*ACE_visitor)(void *acc, Card h[ACEHAND], const int cards[], int weight);
+
+/* Returns 0, or -1 if the threads could not be started.*/
+extern int ACE_enumerate(const Card deck[], int ndeck, const Card base[ACEHAND], int k,
+								 int nthreads, ACE_visitor visit, void *accs, size_t accsize);
+
+/* ACE_enumerate_suits visits one k-card hand from the full deck for each way of
+   filling the suits that isn't just another hand with the suits swapped, with the number
+   of hands it stands for as its weight.  For 7 cards that is 6,009,159 hands instead of
+   133,784,560, and the weights add up to the same counts.  Only use it where the answer
+   doesn't care which suit is which.  `cards` holds card numbers (as for ACE_makecard).*/
+extern int ACE_enumerate_suits(int k, int nthreads, ACE_visitor visit, void *accs, size_t accsize);
+
+/* How many threads the machine can run at once*/
+extern int ACE_ncpus(void);
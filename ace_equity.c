@@ -0,0 +1,259 @@
+/* Showdown equity.
+   See ace_equity.h
+*/
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ace_equity.h"
+#include "ace_enum.h"
+#include "ace_parse.h"
+
+/* Each thread keeps its own copy of the hole cards, and its own counts.
+   The board's suit sums come from the enumeration, and both players add their
+   two cards on top of them.
+*/
+typedef struct {
+  Card hole1[ACEHAND], hole2[ACEHAND];
+  ACE_showdown count;
+  char pad[64];
+} headsup_t;
+
+static void showdown_hu(void *acc, Card board[], const int cards[], int weight){
+  headsup_t *p=acc;
+  Card g[ACEHAND],h[ACEHAND],a,b;
+  int i;
+  (void)cards;  //the board is all we need, not which cards made it
+  for (i=0;i<ACEHAND;i++) {
+	 g[i]=board[i]+p->hole1[i];
+	 h[i]=board[i]+p->hole2[i];
+  }
+  g[3]=board[3]|p->hole1[3];
+  h[3]=board[3]|p->hole2[3];
+  a=ACE_evaluate(g);
+  b=ACE_evaluate(h);
+  if (a>b) p->count.win+=weight;
+  else if (a<b) p->count.lose+=weight;
+  else p->count.tie+=weight;
+}
+
+int ACE_equity_hu(const int hole1[2], const int hole2[2], const int board[], int nboard,
+						int nthreads, ACE_showdown *out){
+  Card deck[52], base[ACEHAND]={0}, g[ACEHAND]={0}, h[ACEHAND]={0};
+  int used[52]={0}, known[9];
+  int i,n=0,ndeck=0,ret;
+  headsup_t *p;
+
+  if (nboard<0 || nboard>5) return -1;
+  known[n++]=hole1[0]; known[n++]=hole1[1];
+  known[n++]=hole2[0]; known[n++]=hole2[1];
+  for (i=0;i<nboard;i++) known[n++]=board[i];
+  for (i=0;i<n;i++) {
+	 if (known[i]<0 || known[i]>51 || used[known[i]]++) return -1;
+	 if (i>=4) ACE_addcard(base,ACE_makecard(known[i]));
+  }
+  for (i=0;i<2;i++) {
+	 ACE_addcard(g,ACE_makecard(hole1[i]));
+	 ACE_addcard(h,ACE_makecard(hole2[i]));
+  }
+  for (i=0;i<52;i++)
+	 if (!used[i]) deck[ndeck++]=ACE_makecard(i);
+
+  if (nthreads<1) nthreads=1;
+  if (!(p=calloc(nthreads,sizeof(headsup_t)))) return -1;
+  for (i=0;i<nthreads;i++) {
+	 memcpy(p[i].hole1,g,sizeof(g));
+	 memcpy(p[i].hole2,h,sizeof(h));
+  }
+  ret=ACE_enumerate(deck,ndeck,base,5-nboard,nthreads,showdown_hu,p,sizeof(headsup_t));
+  memset(out,0,sizeof(*out));
+  for (i=0;i<nthreads;i++) {
+	 out->win+=p[i].count.win;
+	 out->lose+=p[i].count.lose;
+	 out->tie+=p[i].count.tie;
+  }
+  free(p);
+  return ret;
+}
+
+int ACE_parsecard(const char *text){
+  if (!text[0]) return -1;
+  return ACE_cardcode[(unsigned char)text[0]|(unsigned char)text[1]<<8]-1;
+}
+
+
+/* Monte Carlo:
+   Every thread has its own generator, and its own copy of the live deck.
+   A deal is a partial Fisher-Yates shuffle, which stops as soon as it has drawn
+   the cards it needs.  The deck is never put back in order: shuffling a shuffled
+   deck is just as random.
+*/
+typedef struct {
+  uint64_t s[4];
+} rng_t;
+
+static inline uint64_t rotl(uint64_t x, int k){ return x<<k|x>>(64-k); }
+
+//xoshiro256**, by Blackman and Vigna
+static inline uint64_t next(rng_t *r){
+  uint64_t *s=r->s, result=rotl(s[1]*5,7)*9, t=s[1]<<17;
+  s[2]^=s[0];
+  s[3]^=s[1];
+  s[1]^=s[2];
+  s[0]^=s[3];
+  s[2]^=t;
+  s[3]=rotl(s[3],45);
+  return result;
+}
+
+//splitmix64, to turn one seed into well mixed generator states
+static uint64_t splitmix(uint64_t *x){
+  uint64_t z=(*x+=0x9e3779b97f4a7c15);
+  z=(z^(z>>30))*0xbf58476d1ce4e5b9;
+  z=(z^(z>>27))*0x94d049bb133111eb;
+  return z^(z>>31);
+}
+
+//a number in 0..n-1, from the high bits
+static inline int below(rng_t *r, int n){
+  return (int)(((next(r)>>32)*n)>>32);
+}
+
+typedef struct {
+  pthread_t thread;
+  rng_t rng;
+  int nplayers, nhole, nboard, ndeck;
+  Card deck[52];
+  Card base[ACEHAND];                  //the known board
+  Card hole[ACE_MAXPLAYERS][ACEHAND];  //known hole cards, per player
+  int random[ACE_MAXPLAYERS];          //how many random hole cards each player gets
+  long deals, limit;
+  const volatile int *stop;
+  int *finished;
+  double share[ACE_MAXPLAYERS], square[ACE_MAXPLAYERS];
+  char pad[64];  //the next thread's rng and counts are written every deal too
+} montecarlo_t;
+
+static void* deal_mc(void *arg){
+  montecarlo_t *m=arg;
+  int need=m->nhole+5-m->nboard;
+  Card board[ACEHAND], h[ACE_MAXPLAYERS][ACEHAND], v[ACE_MAXPLAYERS], best, c;
+  int i,j,p,r,winners;
+
+  while (m->deals<m->limit && !*m->stop) {
+	 for (i=0;i<need;i++) {
+		r=i+below(&m->rng,m->ndeck-i);
+		c=m->deck[r]; m->deck[r]=m->deck[i]; m->deck[i]=c;
+	 }
+	 memcpy(board,m->base,sizeof(board));
+	 for (i=m->nhole;i<need;i++)
+		ACE_addcard(board,m->deck[i]);
+
+	 best=0;
+	 for (p=0,i=0;p<m->nplayers;p++) {
+		for (j=0;j<ACEHAND;j++)
+		  h[p][j]=board[j]+m->hole[p][j];
+		h[p][3]=board[3]|m->hole[p][3];
+		for (j=0;j<m->random[p];j++,i++)
+		  ACE_addcard(h[p],m->deck[i]);
+		v[p]=ACE_evaluate(h[p]);
+		if (v[p]>best) best=v[p];
+	 }
+	 for (p=0,winners=0;p<m->nplayers;p++)
+		winners+=v[p]==best;
+	 for (p=0;p<m->nplayers;p++)
+		if (v[p]==best) {
+		  m->share[p]+=1.0/winners;
+		  m->square[p]+=1.0/winners/winners;
+		}
+	 m->deals++;
+  }
+  __sync_fetch_and_add(m->finished,1);
+  return NULL;
+}
+
+static double now(void){
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC,&t);
+  return t.tv_sec+t.tv_nsec/1e9;
+}
+
+int ACE_equity_mc(int nplayers, const int hole[][2], const int board[], int nboard,
+						const int dead[], int ndead, long deals, double seconds,
+						int nthreads, uint64_t seed, ACE_equity *out){
+  montecarlo_t *m;
+  Card deck[52], base[ACEHAND]={0}, known[ACE_MAXPLAYERS][ACEHAND]={{0}};
+  int used[52]={0}, random[ACE_MAXPLAYERS]={0};
+  int i,p,t,ndeck=0,nhole=0,started,finished=0;
+  volatile int stop=0;
+  double end;
+  uint64_t x=seed;
+
+  if (nplayers<2 || nplayers>ACE_MAXPLAYERS || nboard<0 || nboard>5 || ndead<0) return -1;
+  if (deals<=0 && seconds<=0) return -1;
+  for (p=0;p<nplayers;p++)
+	 for (i=0;i<2;i++) {
+		int c=hole[p][i];
+		if (c<0) { random[p]++; nhole++; continue; }
+		if (c>51 || used[c]++) return -1;
+		ACE_addcard(known[p],ACE_makecard(c));
+	 }
+  for (i=0;i<nboard;i++) {
+	 if (board[i]<0 || board[i]>51 || used[board[i]]++) return -1;
+	 ACE_addcard(base,ACE_makecard(board[i]));
+  }
+  for (i=0;i<ndead;i++)
+	 if (dead[i]<0 || dead[i]>51 || used[dead[i]]++) return -1;
+  for (i=0;i<52;i++)
+	 if (!used[i]) deck[ndeck++]=ACE_makecard(i);
+  if (nhole+5-nboard>ndeck) return -1;
+
+  if (nthreads<1) nthreads=1;
+  if (!(m=calloc(nthreads,sizeof(montecarlo_t)))) return -1;
+  for (t=0;t<nthreads;t++) {
+	 //one splitmix64 stream for all threads, so no two states overlap
+	 for (i=0;i<4;i++) m[t].rng.s[i]=splitmix(&x);
+	 m[t].nplayers=nplayers;
+	 m[t].nhole=nhole;
+	 m[t].nboard=nboard;
+	 m[t].ndeck=ndeck;
+	 memcpy(m[t].deck,deck,sizeof(deck));
+	 memcpy(m[t].base,base,sizeof(base));
+	 memcpy(m[t].hole,known,sizeof(known));
+	 memcpy(m[t].random,random,sizeof(random));
+	 m[t].limit = deals>0 ? deals/nthreads+(t<deals%nthreads) : LONG_MAX;
+	 m[t].stop=&stop;
+	 m[t].finished=&finished;
+  }
+
+  end=now()+seconds;
+  for (started=0;started<nthreads;started++)
+	 if (pthread_create(&m[started].thread,NULL,deal_mc,&m[started])) break;
+  if (seconds>0) {
+	 while (__sync_fetch_and_add(&finished,0)<started && now()<end) {
+		struct timespec nap={0,1000000};
+		nanosleep(&nap,NULL);
+	 }
+	 stop=1;
+  }
+  for (t=0;t<started;t++)
+	 pthread_join(m[t].thread,NULL);
+
+  memset(out,0,sizeof(*out));
+  for (t=0;t<started;t++)
+	 out->deals+=m[t].deals;
+  for (p=0;p<nplayers && out->deals;p++) {
+	 double sum=0,square=0,mean;
+	 for (t=0;t<started;t++) {
+		sum+=m[t].share[p];
+		square+=m[t].square[p];
+	 }
+	 mean=sum/out->deals;
+	 out->equity[p]=mean;
+	 out->error[p]=sqrt((square/out->deals-mean*mean)/out->deals);
+  }
+  free(m);
+  return started ? 0 : -1;
+}
@@ -0,0 +1,43 @@
+/* Showdown equity.
+ *
+ * Cards are deck positions 0..51, as passed to ACE_makecard.
+ * ACE_parsecard turns text like "AS" or "td" into one, with ace_parse.c's table.
+ */
+#include "ace_eval.h"
+
+/* Showdowns from player 1's side*/
+typedef struct {
+  long win, lose, tie;
+} ACE_showdown;
+
+/* Exact heads-up equity: deals every possible runout of the 0-5 known board cards,
+   and compares both players on each, over nthreads threads.
+   Returns 0, or -1 for a repeated card or a bad board size.
+*/
+extern int ACE_equity_hu(const int hole1[2], const int hole2[2], const int board[], int nboard,
+								 int nthreads, ACE_showdown *out);
+
+/* Monte Carlo equity for 2 to ACE_MAXPLAYERS players.
+   hole[p] holds player p's two cards, either of which may be -1 for a random card.
+   The board may have 0-5 known cards, and `dead` cards are out of the deck.
+   Deals until `deals` runouts are done or `seconds` have passed, whichever is first
+   (0 means no limit, but not both), spread over nthreads threads.  Each thread draws
+   from its own xoshiro256** generator, seeded from
+   the next four outputs of one splitmix64 stream started at `seed`.
+   Returns 0, or -1 for a repeated card or a bad count.
+*/
+#define ACE_MAXPLAYERS 10
+typedef struct {
+  double equity[ACE_MAXPLAYERS];  //share of the pot, split pots shared out
+  double error[ACE_MAXPLAYERS];   //standard error of `equity`
+  long deals;
+} ACE_equity;
+
+extern int ACE_equity_mc(int nplayers, const int hole[][2], const int board[], int nboard,
+								 const int dead[], int ndead, long deals, double seconds,
+								 int nthreads, uint64_t seed, ACE_equity *out);
+
+/* Card text to deck position: rank in "23456789TJQKA", suit in "CDHS", either case.
+   Returns -1 if it isn't a card.
+*/
+extern int ACE_parsecard(const char *text);
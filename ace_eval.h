@@ -1,10 +1,37 @@
+#ifndef ACE_EVAL_H
+#define ACE_EVAL_H
 #include <stdint.h>
+#include <stddef.h>
 #define Card uint32_t
 
+//E keeps no state between calls, so it is safe to call from many threads at once
 extern Card E(Card []);
+extern const char* E_compress(void); //which compressor `E` picked at startup
 
 #define ACEHAND 5
+extern void E_batch(const Card [][ACEHAND], Card [], size_t);
+
+//every hole-card pair on one 5-card board, by combo id; 0 where a card is on the board
+#define ACE_COMBOS 1326
+#define ACE_combo(a,b)  ((b)*((b)-1)/2+(a))  //deck cards a<b
+extern void E_board(const Card board[ACEHAND], Card out[ACE_COMBOS]);
+
+//exactly 5, 6 or 7 cards, from ace_eval_n.c
+extern Card E5(Card []), E6(Card []), E7(Card []);
+
 static inline Card ACE_makecard(int i){return 1<<(2*(i%13)+6)|1<<(i/13);}
 #define ACE_addcard(h,c)  h[c&7]+=c,h[3]|=c 
+
+/* Take a card back out of a hand.
+   The suit words are sums, so subtracting undoes the add, even with duplicate ranks.
+   h[3] is an or, so it is rebuilt from them: a suit never holds the same rank twice,
+   so or-ing the suits gives the ranks, and a suit is present while its count is non-zero.
+*/
+static inline void ACE_removecard(Card h[], Card c){
+  h[c&7]-=c;
+  h[3]=((h[0]|h[1]|h[2]|h[4])&-64)|!!(h[1]&63)|!!(h[2]&63)<<1|!!(h[4]&63)<<2|!!(h[0]&63)<<3;
+}
+#define ACE_swapcard(h,out,in)  (ACE_removecard(h,out),ACE_addcard(h,in))
 #define ACE_evaluate(h)   E((h))
 #define ACE_rank(r)       ((r)>>28)
+#endif
@@ -23,7 +23,6 @@
 /*
     compressor: turn 26 bit-pairs into 13 bits
 */
-Card C,i,X; 
 //#define c(a)for(X=a,i=C=0;X;X/=4}C|=(X&1)<<i++;
 Card compress(Card a){
   int i=0;
@@ -45,8 +44,6 @@ Card compress(Card a){
 */
 #define A(h,c)h[c&7]+=c,h[3]|=c 
 
-/* a few globals
- */
 
 /* The evaluator function:*/
 Card E(Card h[]){ 
@@ -77,6 +74,7 @@ Card E(Card h[]){
   Card value;
   Card kicker =h[3];
   Card temp;
+  Card i;
 
 
 /* Quad detector: the value `v=e&o/2` will be non-zero only if a rank has both 
@@ -201,8 +199,8 @@ Card E(Card h[]){
   4 bits for the type 0..9, 13 bits for the value cards, 13 for the kicker.
  */
   value=compress(value);
-  C=compress(kicker); 
-  return result<<28|value<<13|C;
+  kicker=compress(kicker); 
+  return result<<28|value<<13|kicker;
 } 
 
 
@@ -0,0 +1,183 @@
+/* The batch and board evaluators, for ace_eval_decompress.c, which includes this once
+ * for each lane count it builds.  Before each, it defines
+ *    LANES          hands at a time
+ *    BATCH(name)    the name of this copy's E_batch and E_board
+ *    BATCH_SCOPE    static, or nothing for the copy that is E_batch and E_board
+ * No include guard, on purpose.
+ */
+#define Lanes BATCH(Lanes)
+#define Mask BATCH(Mask)
+#define compress_lanes BATCH(compress_lanes)
+#define eval_lanes BATCH(eval_lanes)
+
+typedef Card Lanes __attribute__((vector_size(LANES*sizeof(Card))));
+typedef int32_t Mask __attribute__((vector_size(LANES*sizeof(Card))));
+
+/* m ? a : b, lane by lane*/
+#undef PICK
+#define PICK(m,a,b) ((Lanes)(m)&(a)|~(Lanes)(m)&(b))
+
+static inline __attribute__((always_inline)) Lanes compress_lanes(Lanes a){
+  a=(a|(a>>1))&0x33333333;
+  a=(a|(a>>2))&0x0f0f0f0f;
+  a=(a|(a>>4))&0x00ff00ff;
+  a=(a|(a>>8))&0x0000ffff;
+  return a>>3;
+}
+
+static inline __attribute__((always_inline)) Lanes eval_lanes(Lanes h0, Lanes h1, Lanes h2, Lanes h3, Lanes h4){
+  Lanes count=h0+h1+h2+h4-(h3&0xFFFFFFF0);
+  Lanes evens=0x55555540&count;
+  Lanes odds =0xAAAAAA80&count;
+  Lanes ranks=h3&0xFFFFFFC0;
+  Lanes pairs=evens&evens-1;  //evens without the lowest pair
+  Lanes result,value,kicker,temp,n;
+  Mask m,flush;
+
+/* flush: at most one suit can hold 5 of 7 cards, so or-ing the masked suits picks it*/
+  Lanes n0=(h0>>3)&7, n1=h1&7, n2=(h2>>1)&7, n4=(h4>>2)&7;
+  Mask f0=n0>4, f1=n1>4, f2=n2>4, f4=n4>4;
+  flush=f0|f1|f2|f4;
+  Lanes suit=((Lanes)f0&h0|(Lanes)f1&h1|(Lanes)f2&h2|(Lanes)f4&h4)&0xFFFFFFC0;
+  n=(Lanes)f0&n0|(Lanes)f1&n1|(Lanes)f2&n2|(Lanes)f4&n4;
+
+/* straight: in the flush suit if there is one, in all cards otherwise*/
+  Lanes run=PICK(flush,suit,ranks);
+  run|=(run>>26)&16;
+  run&=run*4;
+  run&=run*4;
+  run&=run*4;
+  run&=run*4;
+
+/* high card*/
+  result=(Lanes){0};
+  value=(Lanes){0};
+  kicker=ranks&ranks-1;
+  kicker&=kicker-1;
+
+/* one or two pairs, or three pairs where the lowest one becomes a kicker candidate*/
+  m=evens!=0;
+  temp=ranks^evens;
+  temp&=temp-1;
+  temp&=temp-1;
+  result=PICK(m,1-(Lanes)(pairs!=0),result);
+  value=PICK(m,evens,value);
+  kicker=PICK(m,temp,kicker);
+  m=(pairs&pairs-1)!=0;
+  temp=ranks^pairs;
+  value=PICK(m,pairs,value);
+  kicker=PICK(m,temp&temp-1,kicker);
+
+/* three of a kind*/
+  m=odds!=0;
+  temp=ranks^(odds/2);
+  temp&=temp-1;
+  temp&=temp-1;
+  result=PICK(m,(Lanes){0}+3,result);
+  value=PICK(m,odds/2,value);
+  kicker=PICK(m,temp,kicker);
+
+/* flush: keep the top 5 of the 5, 6 or 7 suited cards*/
+  temp=suit&suit-1;
+  temp=PICK(n>5,temp,suit);
+  temp=PICK(n>6,temp&temp-1,temp);
+  result=PICK(flush,(Lanes){0}+5,result);
+  value=PICK(flush,temp,value);
+  kicker=PICK(flush,(Lanes){0},kicker);
+
+/* straight or straight flush: only the highest card of the run counts*/
+  m=run!=0;
+  result=PICK(m,4+((Lanes)flush&5),result);
+  value=PICK(m,run&~(run/4),value);
+  kicker=PICK(m,(Lanes){0},kicker);
+
+/* full house from a set plus one or two pairs*/
+  m=(evens!=0)&(odds!=0);
+  result=PICK(m,(Lanes){0}+6,result);
+  value=PICK(m,odds/2,value);
+  kicker=PICK(m,PICK(pairs!=0,pairs,evens),kicker);
+
+/* full house from two sets*/
+  temp=odds&odds-1;
+  m=temp!=0;
+  result=PICK(m,(Lanes){0}+6,result);
+  value=PICK(m,temp/2,value);
+  kicker=PICK(m,(odds^temp)/2,kicker);
+
+/* four of a kind: the kicker is the highest remaining card*/
+  m=(evens&odds/2)!=0;
+  temp=h3^(evens&odds/2);
+  temp|=temp>>1;
+  temp|=temp>>2;
+  temp|=temp>>4;
+  temp|=temp>>8;
+  temp|=temp>>16;
+  result=PICK(m,(Lanes){0}+7,result);
+  value=PICK(m,evens&odds/2,value);
+  kicker=PICK(m,temp^temp>>1,kicker);
+
+  return result<<28|compress_lanes(value)<<13|compress_lanes(kicker);
+}
+
+BATCH_SCOPE void BATCH(E_batch)(const Card (*hands)[ACEHAND], Card *out, size_t n){
+  Lanes h0,h1,h2,h3,h4;
+  size_t i;
+  int j;
+  for (i=0;i+LANES<=n;i+=LANES){
+	 for (j=0;j<LANES;j++){
+		h0[j]=hands[i+j][0];
+		h1[j]=hands[i+j][1];
+		h2[j]=hands[i+j][2];
+		h3[j]=hands[i+j][3];
+		h4[j]=hands[i+j][4];
+	 }
+	 h0=eval_lanes(h0,h1,h2,h3,h4);
+	 for (j=0;j<LANES;j++)
+		out[i+j]=h0[j];
+  }
+  for (;i<n;i++)
+	 out[i]=E((Card*)hands[i]);
+}
+
+/* Board evaluator: `E_board` values every two-card holding on one 5-card board.
+   The board's suit sums and rank mask are built once.  For each second card b,
+   the first cards 0..b-1 have consecutive combo ids, so a lane-sized run of them
+   is loaded straight from per-suit tables of card words and added on top.
+   out[ACE_combo(a,b)] gets the value of deck cards a,b with the board,
+   or 0 if either card is on the board (a real 7-card value is never 0).
+*/
+BATCH_SCOPE void BATCH(E_board)(const Card board[ACEHAND], Card out[ACE_COMBOS]){
+  //per suit word: the card if it goes there, else 0.  Padded so the last run can read past 51
+  Card add[ACEHAND][52+LANES]={{0}}, live[52+LANES]={0};
+  Lanes h0,h1,h2,h3,h4,r,l;
+  Card c;
+  int a,b,j;
+
+  for (a=0;a<52;a++){
+	 c=ACE_makecard(a);
+	 add[c&7][a]=c;
+	 add[3][a]=c;
+	 live[a]=board[c&7]&c&-64 ? 0 : ~0u;  //0 if the board has it
+  }
+  for (b=1;b<52;b++){
+	 Card *o=out+ACE_combo(0,b);
+	 for (a=0;a<b;a+=LANES){
+		memcpy(&h0,add[0]+a,sizeof(Lanes));
+		memcpy(&h1,add[1]+a,sizeof(Lanes));
+		memcpy(&h2,add[2]+a,sizeof(Lanes));
+		memcpy(&h3,add[3]+a,sizeof(Lanes));
+		memcpy(&h4,add[4]+a,sizeof(Lanes));
+		memcpy(&l,live+a,sizeof(Lanes));
+		r=eval_lanes(h0+(board[0]+add[0][b]),h1+(board[1]+add[1][b]),h2+(board[2]+add[2][b]),
+						 h3|(board[3]|add[3][b]),h4+(board[4]+add[4][b]));
+		r&=l&live[b];
+		for (j=0;j<LANES && a+j<b;j++)
+		  o[a+j]=r[j];
+	 }
+  }
+}
+
+#undef Lanes
+#undef Mask
+#undef compress_lanes
+#undef eval_lanes
@@ -0,0 +1,159 @@
+/* Mini poker hand evaluator.
+ * Takes a hand of 5-7 cards,
+ * returns a 32 bit int representing its rank.
+ *
+ * Cards are stored in a 32 bit word which has the following (implied) structure:
+
+    struct card{
+       unsigned num_A:2;
+       unsigned num_K:2;
+       unsigned num_Q:2;
+       //....
+       unsigned num_2:2;
+       unsigned spare:2;
+       unsigned spade:1;
+       unsigned heart:1;
+       unsigned diamond:1;
+       unsigned club:1;
+       };
+
+ * This is the branchless version of `ace_eval_decompress.c`.
+ * It computes every hand type, and picks the answer with masks instead of returning early,
+ * so it takes the same time for every hand.
+*/
+#include <stdint.h>
+#include "ace_eval.h"
+/*
+    compressor: turn 26 bit-pairs into 13 bits
+*/
+Card compress(Card a){
+  a=(a|(a>>1))&0x33333333;
+  a=(a|(a>>2))&0x0f0f0f0f;
+  a=(a|(a>>4))&0x00ff00ff;
+  a=(a|(a>>8))&0x0000ffff;
+  return a>>3;
+}
+
+/* `m` is all ones or all zeros: m ? a : b
+   `MASK` turns a truth value into one of those. */
+#define PICK(m,a,b) ((m)&(a)|~(m)&(b))
+#define MASK(x)     (-(Card)((x)!=0))
+
+/* The evaluator function:*/
+Card E(Card h[]){
+  /*variables:
+    count: the sum of all suits, less h[3]. Every 2-bit field holds the count-1 for that rank.
+    evens: a bit set in any rank which has a 1(pair) or 3(quad).
+    odds:  a bit for every 2(set) or 3(quad).
+    ranks: one bit for each rank present.
+    pairs: evens with the lowest pair removed.
+    suit:  the cards of the flush suit, `n` is how many there are.
+    run:   non-zero if there are 5 cards in a row.
+    result, value, kicker: as in the other versions,
+       they are first set for high card, then overwritten by each better hand type that matches.
+  */
+  Card count=h[0]+h[1]+h[2]+h[4]-(h[3]&-16L);
+  Card evens=0x55555540&count;
+  Card odds =0xAAAAAA80&count;
+  Card ranks=h[3]&-64;
+  Card pairs=evens&evens-1;
+  Card result,value,kicker,temp,suit,n,run,m,flush;
+  Card m0,m1,m2,m4,n0,n1,n2,n4;
+
+/* Flush detector:
+   Only one suit can hold 5 of 7 cards, so or-ing together the masked suits selects it.
+ */
+  n0=(h[0]>>3)&7; m0=MASK(n0>4);
+  n1=h[1]&7;      m1=MASK(n1>4);
+  n2=(h[2]>>1)&7; m2=MASK(n2>4);
+  n4=(h[4]>>2)&7; m4=MASK(n4>4);
+  flush=m0|m1|m2|m4;
+  suit=(m0&h[0]|m1&h[1]|m2&h[2]|m4&h[4])&-64;
+  n=m0&n0|m1&n1|m2&n2|m4&n4;
+
+/* Straight detector, using the flush suit if there is one.
+   The ace is copied down to the ones position to catch 5-high straights.
+ */
+  run=PICK(flush,suit,ranks);
+  run|=(run>>26)&16;
+  run&=run*4;
+  run&=run*4;
+  run&=run*4;
+  run&=run*4;
+
+/* High card: keep the top 5 cards as kickers*/
+  result=0;
+  value=0;
+  kicker=ranks&ranks-1;
+  kicker&=kicker-1;
+
+/* Pairs: 1 or 2 pairs keep 3 or 1 kicker.
+   With 3 pairs, the lowest pair is just another kicker candidate.
+ */
+  m=MASK(evens);
+  temp=ranks^evens;
+  temp&=temp-1;
+  temp&=temp-1;
+  result=PICK(m,1+(pairs!=0),result);
+  value=PICK(m,evens,value);
+  kicker=PICK(m,temp,kicker);
+  m=MASK(pairs&pairs-1);
+  temp=ranks^pairs;
+  value=PICK(m,pairs,value);
+  kicker=PICK(m,temp&temp-1,kicker);
+
+/* Three of a kind*/
+  m=MASK(odds);
+  temp=ranks^odds/2;
+  temp&=temp-1;
+  temp&=temp-1;
+  result=PICK(m,3,result);
+  value=PICK(m,odds/2,value);
+  kicker=PICK(m,temp,kicker);
+
+/* Flush: keep the top 5 of the 5, 6 or 7 suited cards.
+   `x&x-(c)` clears the low bit only when c is 1.
+ */
+  temp=suit&suit-(n>5);
+  temp&=temp-(n>6);
+  result=PICK(flush,5,result);
+  value=PICK(flush,temp,value);
+  kicker&=~flush;
+
+/* Straight or straight flush: only the top card of the run counts*/
+  m=MASK(run);
+  result=PICK(m,4+(flush&5),result);
+  value=PICK(m,run&~(run/4),value);
+  kicker&=~m;
+
+/* Full house from a set and one or two pairs*/
+  m=MASK(evens&&odds);
+  result=PICK(m,6,result);
+  value=PICK(m,odds/2,value);
+  kicker=PICK(m,PICK(MASK(pairs),pairs,evens),kicker);
+
+/* Full house from two sets*/
+  temp=odds&odds-1;
+  m=MASK(temp);
+  result=PICK(m,6,result);
+  value=PICK(m,temp/2,value);
+  kicker=PICK(m,(odds^temp)/2,kicker);
+
+/* Four of a kind: smear the remaining cards down, and keep the top one as the kicker*/
+  m=MASK(evens&odds/2);
+  temp=h[3]^(evens&odds/2);
+  temp|=temp>>1;
+  temp|=temp>>2;
+  temp|=temp>>4;
+  temp|=temp>>8;
+  temp|=temp>>16;
+  result=PICK(m,7,result);
+  value=PICK(m,evens&odds/2,value);
+  kicker=PICK(m,temp^temp>>1,kicker);
+
+/*
+  build the final result.
+  4 bits for the type 0..9, 13 bits for the value cards, 13 for the kicker.
+ */
+  return result<<28|compress(value)<<13|compress(kicker);
+}
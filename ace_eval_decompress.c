@@ -19,12 +19,13 @@
 
 */
 #include <stdint.h>
+#include <string.h>
 #include "ace_eval.h"
 /*
     compressor: turn 26 bit-pairs into 13 bits
 */
 #define DECOMPRESS2
-Card C,i,X; 
+#define PEXT_DISPATCH  //use BMI2 `pext` for compress when the cpu does it fast
 //#define c(a)for(X=a,i=C=0;X;X/=4}C|=(X&1)<<i++;
 #ifdef DECOMPRESS1
 Card compress(Card a){
@@ -88,11 +89,11 @@ Card compress(Card x){
 */
 #define A(h,c)h[c&7]+=c,h[3]|=c 
 
-/* a few globals
- */
 
-/* The evaluator function:*/
-Card E(Card h[]){ 
+/* The evaluator function:
+   It takes the compressor as a parameter, so each `E` below gets its own inlined copy.
+*/
+static inline __attribute__((always_inline)) Card evaluate(Card h[], Card compress(Card)){ 
   /*variables:
 	 a: the sum of all suits. counts the ranks in paralell. 
        But there are only 2 bits used to store each rank, so 4 of a kind will overflow. 
@@ -273,4 +274,74 @@ Card E(Card h[]){
   return 0|0<<13|compress(kicker);
 }
 
+/* `E` uses `pext` for compress where the cpu does it fast, picked when the program loads.
+   See ace_dispatch.h
+*/
+#include "ace_dispatch.h"
+ACE_EVALUATOR(E,compress,evaluate)
+ACE_COMPRESS_NAME
+
+
+
+
+/* Batch evaluator: `E_batch` runs the same evaluation on 8 hands at once (16 with AVX-512).
+   Every detector is computed for every lane, and the results are picked with lane masks
+   from lowest to highest priority, so there are no branches to mispredict.
+   The final value is bit-identical to `E`.
+   Built with -mavx2 or -mavx512f, it uses those.  Otherwise, on x86-64 with gcc, it is
+   built three times, for AVX-512, AVX2 and SSE2 (16, 8 and 4 lanes), and an `ifunc`
+   picks one for the cpu when the program loads.  Elsewhere it is 4 hands in SSE registers.
+   The code is in ace_eval_batch.h.
+*/
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__) && !defined(__AVX2__)
+#define BATCH_SCOPE static
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#define LANES 16
+#define BATCH(name) name##_16
+#include "ace_eval_batch.h"
+#undef LANES
+#undef BATCH
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#define LANES 8
+#define BATCH(name) name##_8
+#include "ace_eval_batch.h"
+#undef LANES
+#undef BATCH
+#pragma GCC pop_options
 
+#define LANES 4
+#define BATCH(name) name##_4
+#include "ace_eval_batch.h"
+
+static int lanes(void){
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx512f") ? 16 : __builtin_cpu_supports("avx2") ? 8 : 4;
+}
+static void (*resolve_batch(void))(const Card (*)[ACEHAND], Card *, size_t){
+  int n=lanes();
+  return n==16 ? E_batch_16 : n==8 ? E_batch_8 : E_batch_4;
+}
+static void (*resolve_board(void))(const Card [ACEHAND], Card [ACE_COMBOS]){
+  int n=lanes();
+  return n==16 ? E_board_16 : n==8 ? E_board_8 : E_board_4;
+}
+void E_batch(const Card [][ACEHAND], Card [], size_t) __attribute__((ifunc("resolve_batch")));
+void E_board(const Card [ACEHAND], Card [ACE_COMBOS]) __attribute__((ifunc("resolve_board")));
+
+#else
+#if defined(__AVX512F__)
+#define LANES 16
+#elif defined(__AVX2__)
+#define LANES 8
+#else
+#define LANES 4
+#endif
+#define BATCH(name) name
+#define BATCH_SCOPE
+#include "ace_eval_batch.h"
+#endif
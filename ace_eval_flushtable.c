@@ -26,7 +26,6 @@ static const int nc[8]={0,0,0,0,0,1,1,1};
 /*
     compressor: turn 26 bit-pairs into 13 bits
 */
-Card C,i,X; 
 //#define c(a)for(X=a,i=C=0;X;X/=4}C|=(X&1)<<i++;
 Card compress(Card a){
   int i=0;
@@ -48,8 +47,6 @@ Card compress(Card a){
 */
 #define A(h,c)h[c&7]+=c,h[3]|=c 
 
-/* a few globals
- */
 
 /* The evaluator function:*/
 Card E(Card h[]){ 
@@ -80,6 +77,7 @@ Card E(Card h[]){
   Card value;
   Card kicker =h[3];
   Card temp;
+  Card i;
 
 
 /* Quad detector: the value `v=e&o/2` will be non-zero only if a rank has both 
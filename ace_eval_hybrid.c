@@ -0,0 +1,117 @@
+/* Hybrid hand evaluator: arithmetic for the counts, one small table for the rank masks.
+ *
+ * Takes 7 cards, returns the same value as `E` in ace_eval_decompress.c.
+ * Quads and full houses are found from the rank counts exactly as there.
+ * Everything else is decided by a set of ranks: the flush suit's, or all the ranks in h[3].
+ * `ranktable` has an entry for each of the 8192 sets, so one load gives:
+ *    STRAIGHT set: the top card of the highest straight (the 5 for A-5), one bit
+ *    otherwise:    the top 5 ranks (all of them if there are fewer)
+ * That replaces the four shift-and steps of the straight detector, and the loops that
+ * trim a flush or a high card hand down to 5.  The sets are compressed before the load,
+ * so the result is built from 13 bit masks and the kickers need no compress at the end.
+ *
+ * The table is 8192 uint16_t, 16K: it fits in L1 with room to spare, but it is room the
+ * caller's own data no longer has.  It is built when the program loads.
+ * Compress uses `pext` or DECOMPRESS2, picked at load time by ace_dispatch.h.
+ */
+#include <stdint.h>
+#include "ace_eval.h"
+
+#define STRAIGHT 0x8000
+#define RANKS    0x1FFF
+
+static uint16_t ranktable[8192];
+
+__attribute__((constructor))
+static void build_ranktable(void){
+  Card m,run,k;
+  for (m=0;m<8192;m++) {
+	 run=m<<1|(m>>12&1);  //one place up, with the ace below the 2 as well
+	 run&=run>>1;
+	 run&=run>>1;
+	 run&=run>>1;
+	 run&=run>>1;         //the low card of each 5 in a row
+	 if (run) {
+		ranktable[m]=STRAIGHT|1<<(31-__builtin_clz(run)+3);
+		continue;
+	 }
+	 for (k=m;__builtin_popcount(k)>5;k&=k-1);
+	 ranktable[m]=k;
+  }
+}
+
+Card compress(Card a){
+  a=(a|(a>>1))&0x33333333;
+  a=(a|(a>>2))&0x0f0f0f0f;
+  a=(a|(a>>4))&0x00ff00ff;
+  a=(a|(a>>8))&0x0000ffff;
+  return a>>3;
+}
+
+/* The variables are as in ace_eval_decompress.c, except that `ranks` and everything
+   after it are compressed 13 bit masks.*/
+static inline __attribute__((always_inline)) Card evaluate(Card h[], Card compress(Card)){
+  Card count=h[0]+h[1]+h[2]+h[4]-(h[3]&-16L);
+  Card evens=0x55555540&count;
+  Card odds =0xAAAAAA80&count;
+  Card value, kicker, temp, ranks, entry;
+
+/* Four of a kind, and full houses, straight from the counts*/
+  if (value=evens&odds/2) {
+	 kicker=(h[3]&-64)^value;
+	 while (temp=kicker&kicker-1)
+		kicker=temp;
+	 return 7<<28|compress(value)<<13|compress(kicker);
+  }
+  if (value=odds&odds-1) {
+	 value/=2;
+	 return 6<<28|compress(value)<<13|compress((odds/2)^value);
+  }
+  if (evens&&odds) {
+	 temp=evens&evens-1;
+	 return 6<<28|compress(odds/2)<<13|compress(temp ? temp : evens);
+  }
+
+/* Flush: only one suit can have 5 of 7, and its entry is a straight flush or the top 5*/
+  if ((h[0]>>3&7)>4) kicker=h[0];
+  else if ((h[1]&7)>4) kicker=h[1];
+  else if ((h[2]>>1&7)>4) kicker=h[2];
+  else if ((h[4]>>2&7)>4) kicker=h[4];
+  else kicker=0;
+  if (kicker) {
+	 entry=ranktable[compress(kicker&-64)];
+	 return (entry&STRAIGHT ? 9<<28 : 5<<28)|(entry&RANKS)<<13;
+  }
+
+/* Straight, then the rest by the compressed ranks*/
+  ranks=compress(h[3]&-64);
+  entry=ranktable[ranks];
+  if (entry&STRAIGHT)
+	 return 4<<28|(entry&RANKS)<<13;
+  if (value=odds/2) {
+	 value=compress(value);
+	 kicker=ranks^value;
+	 kicker&=kicker-1;
+	 kicker&=kicker-1;
+	 return 3<<28|value<<13|kicker;
+  }
+  if (evens) {
+	 evens=compress(evens);
+	 temp=evens&evens-1;
+	 if (temp&temp-1) {
+		kicker=ranks^temp;
+		kicker&=kicker-1;
+		return 2<<28|temp<<13|kicker;
+	 }
+	 kicker=ranks^evens;
+	 kicker&=kicker-1;
+	 kicker&=kicker-1;
+	 return 1+(temp>0)<<28|evens<<13|kicker;
+  }
+  return entry;  //high card: the top 5
+}
+
+#define PEXT_DISPATCH
+#include "ace_dispatch.h"
+ACE_EVALUATOR(E,compress,evaluate)
+ACE_COMPRESS_NAME
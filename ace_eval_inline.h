@@ -0,0 +1,24 @@
+/* The evaluator as a static inline function, for hot loops.
+ *
+ * `E` lives in its own file, so every call is an opaque function call: the caller's loop
+ * can't keep anything in registers across it, or start on the next hand while this one finishes.
+ * `ACE_eval(h)` is `evaluate_n` from ace_eval_n.h for 7 cards, the same as `E7`
+ * (and bit-identical to `E` on 7 cards), compiled into the caller.
+ *
+ * There is no `ifunc` here, that only works through a call.  The compressor is picked
+ * when the caller is compiled: `pext` with BMI2 (-mbmi2, or -march=native on a cpu that has it),
+ * DECOMPRESS2 otherwise.  Don't use -mbmi2 for AMD before Zen3, whose `pext` is slow.
+ */
+#ifndef ACE_EVAL_INLINE_H
+#define ACE_EVAL_INLINE_H
+#include "ace_eval_n.h"
+
+#ifdef __BMI2__
+#include <immintrin.h>
+static inline Card ACE_compress_inline(Card a){ return _pext_u32(a,0x55555540); }
+#else
+#define ACE_compress_inline compress_n
+#endif
+
+static inline Card ACE_eval(Card h[]){ return evaluate_n(h,7,ACE_compress_inline); }
+#endif
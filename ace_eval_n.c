@@ -0,0 +1,23 @@
+/* Hand evaluators specialized for 5, 6 and 7 cards.
+   See ace_eval_n.h
+
+   E5, E6 and E7 can all be used in the same program.
+   `E` is the one for NCARDS cards (7 unless it is defined), for speed_test, accuracy_test and euler.
+   Each one picks `pext` or DECOMPRESS2 when the program loads, by ace_dispatch.h.
+*/
+#include "ace_eval_n.h"
+
+#ifndef NCARDS
+#define NCARDS 7
+#endif
+#define PEXT_DISPATCH
+
+#include "ace_dispatch.h"
+
+#define EVALUATOR(name,n) ACE_EVALUATOR(name,compress_n,evaluate_n,n)
+ACE_COMPRESS_NAME
+
+EVALUATOR(E5,5)
+EVALUATOR(E6,6)
+EVALUATOR(E7,7)
+EVALUATOR(E,NCARDS)
@@ -0,0 +1,106 @@
+/* Mini poker hand evaluator, specialized by hand size.
+ *
+ * `E` takes 5-7 cards, but the kickers it keeps are only right for 7.
+ * `evaluate_n(h, n, compress)` is the same evaluator with the number of cards as a parameter.
+ * Each caller passes a constant, and since the body is always inlined, the compiler
+ * drops the paths that can't happen with that many cards:
+ *    5 cards: no second set, no third pair, no kickers to trim, a flush is exactly 5.
+ *    6 cards: a third pair is the only kicker, trim 1 kicker elsewhere.
+ *    7 cards: the same as `E`.
+ * ace_eval_n.c builds E5, E6 and E7 from it.
+ */
+#ifndef ACE_EVAL_N_H
+#define ACE_EVAL_N_H
+#include "ace_eval.h"
+
+static inline Card compress_n(Card a){
+  a=(a|(a>>1))&0x33333333;
+  a=(a|(a>>2))&0x0f0f0f0f;
+  a=(a|(a>>4))&0x00ff00ff;
+  a=(a|(a>>8))&0x0000ffff;
+  return a>>3;
+}
+
+//clear the lowest `n` bits, n is a constant so the loop unrolls away
+static inline __attribute__((always_inline)) Card trim_n(Card k, int n){
+  while (n-->0) k&=k-1;
+  return k;
+}
+
+/* The variables are as in ace_eval_decompress.c, and so is the compressor parameter.*/
+static inline __attribute__((always_inline)) Card evaluate_n(Card h[], const int n, Card compress(Card)){
+  Card count=h[0]+h[1]+h[2]+h[4]-(h[3]&-16L);
+  Card evens=0x55555540&count;
+  Card odds =0xAAAAAA80&count;
+  Card result=0;
+  Card value;
+  Card kicker=h[3];
+  Card temp;
+
+/* Four of a kind: the kicker is the highest other rank, which is the only one with 5 cards*/
+  if (value=evens&odds/2) {
+	 kicker=(h[3]&-64)^value;
+	 if (n>5)
+		while (temp=kicker&kicker-1)
+		  kicker=temp;
+	 return 7<<28|compress(value)<<13|compress(kicker);
+  }
+
+/* Full house from two sets, which takes 6 cards*/
+  if (n>5 && (value=odds&odds-1)) {
+	 value/=2;
+	 kicker=(odds/2)^value;
+	 return 6<<28|compress(value)<<13|compress(kicker);
+  }
+
+/* Full house from a set and a pair. Only 7 cards can have a second pair to drop*/
+  if (evens&&odds) {
+	 value=odds/2;
+	 if (n>6 && (temp=evens&evens-1))
+		evens=temp;
+	 return 6<<28|compress(value)<<13|compress(evens);
+  }
+
+/* Flush: the suit with 5 or more*/
+  if ((count=(h[0]>>3)&7)>4) { kicker=h[0]; result=5;}
+  else if ((count=h[1]&7)>4) { kicker=h[1]; result=5;}
+  else if ((count=(h[2]>>1)&7)>4) { kicker=h[2]; result=5;}
+  else if ((count=(h[4]>>2)&7)>4) { kicker=h[4]; result=5;}
+
+/* Straight, in the flush suit if there is one*/
+  kicker&=-64;
+  value=kicker|(kicker>>26)&16;
+  value&=value*4;
+  value&=value*4;
+  value&=value*4;
+  value&=value*4;
+  if (value) {
+	 result+=4;
+	 value&=~(value/4);
+	 return result<<28|compress(value)<<13;
+  }
+
+/* Flush: keep the top 5*/
+  if (result) {
+	 if (n>5)
+		while (count-->5)
+		  kicker&=kicker-1;
+	 return 5<<28|compress(kicker)<<13;
+  }
+
+/* Three of a kind: keep 2 kickers of n-3*/
+  if (value=odds/2)
+	 return 3<<28|compress(value)<<13|compress(trim_n(kicker^value,n-5));
+
+/* Pairs: 3 pairs (6 or 7 cards) keep the best of the low pair and the other card*/
+  if (evens) {
+	 temp=evens&evens-1;
+	 if (n>5 && temp&temp-1)
+		return 2<<28|compress(temp)<<13|compress(trim_n(kicker^temp,n-6));
+	 return 1+(temp>0)<<28|compress(evens)<<13|compress(trim_n(kicker^evens,n-5));
+  }
+
+/* High card*/
+  return compress(trim_n(kicker,n-5));
+}
+#endif
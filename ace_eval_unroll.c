@@ -23,7 +23,6 @@
 /*
     compressor: turn 26 bit-pairs into 13 bits
 */
-Card C,i,X; 
 //#define c(a)for(X=a,i=C=0;X;X/=4}C|=(X&1)<<i++;
 Card compress(Card a){
   int i=0;
@@ -45,8 +44,6 @@ Card compress(Card a){
 */
 #define A(h,c)h[c&7]+=c,h[3]|=c 
 
-/* a few globals
- */
 
 /* The evaluator function:*/
 Card E(Card h[]){ 
@@ -176,7 +173,7 @@ Card E(Card h[]){
   ((i will be 0 for cases below here))
  */
 //  else if(i=t){for(i=(h[v&7]&63)/v;i-->5;)k&=k-1;v=k;} //k^v has 0 bits, i does not matter
-  else if (i=result){
+  else if (result){
 	 while(count-->5){
 		kicker&=kicker-1; //k^v has 0 bits, i does not matter
 	 }
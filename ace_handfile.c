@@ -0,0 +1,105 @@
+/* Binary hand files.
+   See ace_handfile.h
+*/
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ace_handfile.h"
+
+#define CHUNK 2048  //records per step: 16K in, 40K of hands, 8K out
+
+static int writeall(int fd, const void *buf, size_t n){
+  const char *p=buf;
+  ssize_t w;
+  while (n) {
+	 if ((w=write(fd,p,n))<=0) return -1;
+	 p+=w;
+	 n-=w;
+  }
+  return 0;
+}
+
+long ACE_handfile_convert(const char *text, const char *out, int ncards, long *bad){
+  uint8_t records[CHUNK][ACE_RECORD];
+  ACE_handhead head={.magic=ACE_HANDMAGIC, .version=1, .ncards=ncards};
+  ACE_parser ps;
+  size_t n,i,m;
+  int fd;
+
+  if (ncards<0 || ncards>7) return -1;  //E takes at most 7
+  if (ACE_parse_open(&ps,text,ncards)) return -1;
+  if ((fd=open(out,O_WRONLY|O_CREAT|O_TRUNC,0666))<0) { ACE_parse_close(&ps); return -1; }
+  if (writeall(fd,&head,sizeof(head))) goto fail;
+  while ((n=ACE_parse_records(&ps,records,CHUNK))) {
+	 for (i=m=0;i<n;i++) {  //with ncards 0 a line can hold 8, one too many
+		if (records[i][7]!=ACE_NOCARD) { ps.bad++; continue; }
+		if (m<i) memcpy(records[m],records[i],ACE_RECORD);
+		m++;
+	 }
+	 if (writeall(fd,records,m*ACE_RECORD)) goto fail;
+	 head.count+=m;
+  }
+  //now the count is known
+  if (pwrite(fd,&head,sizeof(head),0)!=sizeof(head)) goto fail;
+  if (bad) *bad=ps.bad;
+  ACE_parse_close(&ps);
+  return close(fd) ? -1 : (long)head.count;
+
+ fail:
+  ACE_parse_close(&ps);
+  close(fd);
+  return -1;
+}
+
+int ACE_handfile_open(ACE_handfile *f, const char *path){
+  struct stat st;
+  void *map;
+  int fd=open(path,O_RDONLY);
+  memset(f,0,sizeof(*f));
+  if (fd<0) return -1;
+  if (fstat(fd,&st) || st.st_size<(off_t)sizeof(ACE_handhead)) { close(fd); return -1; }
+  map=mmap(NULL,st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+  close(fd);
+  if (map==MAP_FAILED) return -1;
+  f->head=map;
+  f->size=st.st_size;
+  f->count=f->head->count;
+  if (memcmp(f->head->magic,ACE_HANDMAGIC,4) || f->head->version!=1
+		|| f->count>(f->size-sizeof(ACE_handhead))/ACE_RECORD) {
+	 ACE_handfile_close(f);
+	 return -1;
+  }
+  f->records=(const void*)(f->head+1);
+  madvise(map,f->size,MADV_SEQUENTIAL);
+  return 0;
+}
+
+void ACE_handfile_close(ACE_handfile *f){
+  if (f->head) munmap((void*)f->head,f->size);
+  memset(f,0,sizeof(*f));
+}
+
+void ACE_handfile_eval(const ACE_handfile *f, size_t first, size_t n, Card out[]){
+  Card hands[CHUNK][ACEHAND], cards[256];
+  const uint8_t *r;
+  size_t i,m;
+  int k;
+
+  for (k=0;k<256;k++)
+	 cards[k]=k<52 ? ACE_makecard(k) : 0;
+  while (n) {
+	 m = n<CHUNK ? n : CHUNK;
+	 for (i=0;i<m;i++) {
+		r=f->records[first+i];
+		memset(hands[i],0,sizeof(hands[i]));
+		for (k=0;k<ACE_RECORD && r[k]!=ACE_NOCARD;k++)
+		  ACE_addcard(hands[i],cards[r[k]]);
+	 }
+	 E_batch(hands,out,m);
+	 first+=m;
+	 out+=m;
+	 n-=m;
+  }
+}
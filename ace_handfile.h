@@ -0,0 +1,41 @@
+/* Binary hand files.
+ *
+ * A 16 byte header, then one 8 byte record per hand: its cards as deck positions
+ * (0..51, as passed to ACE_makecard), and ACE_NOCARD after the last one.
+ * A 7 card hand takes 8 bytes, against 20 for a Card[ACEHAND] and 21 for text.
+ *
+ * ACE_handfile_convert turns text (see ace_parse.h) into a hand file, of hands of at
+ * most 7 cards: it fails for ncards>7, and counts a longer hand's line as bad.
+ * ACE_handfile_open maps one, and ACE_handfile_eval evaluates a run of its records
+ * into an array of results, a cache-sized chunk at a time.
+ */
+#ifndef ACE_HANDFILE_H
+#define ACE_HANDFILE_H
+#include "ace_parse.h"
+
+#define ACE_HANDMAGIC "ACEH"
+typedef struct {
+  char magic[4];     //ACE_HANDMAGIC
+  uint8_t version;   //1
+  uint8_t ncards;    //cards in every hand, 0 if they differ
+  uint8_t spare[2];
+  uint64_t count;    //how many records follow
+} ACE_handhead;
+
+typedef struct {
+  const ACE_handhead *head;
+  const uint8_t (*records)[ACE_RECORD];
+  size_t count;
+  size_t size;       //of the whole mapping
+} ACE_handfile;
+
+/* Returns the number of hands written, or -1. `bad` gets the number of text lines skipped*/
+extern long ACE_handfile_convert(const char *text, const char *out, int ncards, long *bad);
+
+/* Returns 0, or -1 if it can't be mapped or isn't a hand file*/
+extern int ACE_handfile_open(ACE_handfile *f, const char *path);
+extern void ACE_handfile_close(ACE_handfile *f);
+
+/* out[i] = E of record first+i, for i<n*/
+extern void ACE_handfile_eval(const ACE_handfile *f, size_t first, size_t n, Card out[]);
+#endif
@@ -0,0 +1,92 @@
+/* Omaha hand evaluator.
+   See ace_omaha.h
+
+   A hand is one of the 6 pairs of hole cards with one of the 10 board triples (on the river).
+   Each pair and triple is summed once, so a hand is just two additions:
+     sum:   the rank bits added up, so each 2 bit field counts the cards of that rank
+     ranks: the rank bits or-ed, one bit for each rank present
+     suit:  the suit bit if all the cards share it, else 0
+   Five cards of one suit need a suited pair and a suited triple of the same suit,
+   so the flush check is skipped unless some pair and triple agree.
+*/
+#include "ace_omaha.h"
+
+static Card compress(Card a){
+  a=(a|(a>>1))&0x33333333;
+  a=(a|(a>>2))&0x0f0f0f0f;
+  a=(a|(a>>4))&0x00ff00ff;
+  a=(a|(a>>8))&0x0000ffff;
+  return a>>3;
+}
+
+/* The hands are compared before compressing, with the type and both rank masks
+   packed in 64 bits.  Only the winner gets compressed.*/
+#define KEY(t,v,k)  ((uint64_t)(t)<<52|(uint64_t)((v)>>6)<<26|((k)>>6))
+
+/* Exactly 5 cards, so unlike `E` no kickers need trimming,
+   and there is no second set or third pair to think about.*/
+static inline uint64_t eval5(Card sum, Card ranks, int flush){
+  Card count=sum-ranks;  //each 2 bit field holds the count-1 for that rank
+  Card evens=0x55555540&count;
+  Card odds =0xAAAAAA80&count;
+  Card value;
+
+  if (count) {
+	 if (value=evens&odds/2) return KEY(7,value,ranks^value);
+	 if (evens&&odds)        return KEY(6,odds/2,evens);
+	 if (odds)               return KEY(3,odds/2,ranks^odds/2);
+	 return KEY(1+((evens&evens-1)!=0),evens,ranks^evens);
+  }
+  //five different ranks: straight, flush or high card
+  value=ranks|(ranks>>26)&16;
+  value&=value*4;
+  value&=value*4;
+  value&=value*4;
+  value&=value*4;
+  if (value) return KEY(flush?9:4,value,0);
+  if (flush) return KEY(5,ranks,0);
+  return KEY(0,0,ranks);
+}
+
+Card ACE_omaha(const Card hole[4], const Card board[], int nboard){
+  Card psum[6],pranks[6],psuit[6],tsum[10],tranks[10],tsuit[10];
+  int a,b,c,p=0,t=0,i,j,flush=0;
+  uint64_t best=0,v;
+
+  for (a=0;a<3;a++)
+	 for (b=a+1;b<4;b++,p++) {
+		psum[p]=(hole[a]&-64)+(hole[b]&-64);
+		pranks[p]=(hole[a]|hole[b])&-64;
+		psuit[p]=hole[a]&hole[b]&15;
+	 }
+  for (a=0;a<nboard-2;a++)
+	 for (b=a+1;b<nboard-1;b++)
+		for (c=b+1;c<nboard;c++,t++) {
+		  tsum[t]=(board[a]&-64)+(board[b]&-64)+(board[c]&-64);
+		  tranks[t]=(board[a]|board[b]|board[c])&-64;
+		  tsuit[t]=board[a]&board[b]&board[c]&15;
+		  flush|=tsuit[t];
+		}
+
+  //can any pair and triple make a flush?
+  for (i=0,a=0;i<p;i++)
+	 a|=psuit[i];
+  flush&=a;
+
+  if (!flush)
+	 for (i=0;i<p;i++)
+		for (j=0;j<t;j++) {
+		  v=eval5(psum[i]+tsum[j],pranks[i]|tranks[j],0);
+		  if (v>best) best=v;
+		}
+  else
+	 for (i=0;i<p;i++)
+		for (j=0;j<t;j++) {
+		  v=eval5(psum[i]+tsum[j],pranks[i]|tranks[j],psuit[i]&tsuit[j]);
+		  if (v>best) best=v;
+		}
+
+  return (Card)(best>>52)<<28
+	 |compress((best>>26&0x3FFFFFF)<<6)<<13
+	 |compress((best&0x3FFFFFF)<<6);
+}
@@ -0,0 +1,17 @@
+/* Omaha hand evaluator.
+ *
+ * An Omaha hand must use exactly 2 of its 4 hole cards and 3 of the board cards,
+ * so `E`, which takes the best 5 of all the cards, gets it wrong.
+ * ACE_omaha takes the cards as made by ACE_makecard, and a board of 3 to 5 cards,
+ * and returns the value of the best legal hand in the same format as `E`.
+ * Values from ACE_omaha compare with each other, and with `E5` (ace_eval_n.c) on any
+ * 5 card hand.  Not with `E`, whose kickers are only right for 7 cards.
+ *
+ * Like `E`, it keeps no state, so any number of threads can call it.
+ */
+#ifndef ACE_OMAHA_H
+#define ACE_OMAHA_H
+#include "ace_eval.h"
+
+extern Card ACE_omaha(const Card hole[4], const Card board[], int nboard);
+#endif
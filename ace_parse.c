@@ -0,0 +1,122 @@
+/* Streaming card parser.
+   See ace_parse.h
+*/
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ace_parse.h"
+
+uint8_t ACE_cardcode[65536];
+static Card cards[52];
+
+__attribute__((constructor))
+static void build_cardcode(void){
+  static const char ranks[]="23456789TJQKA", suits[]="CDHS";
+  int r,s,i;
+  for (s=0;s<4;s++)
+	 for (r=0;r<13;r++)
+		for (i=0;i<4;i++) {  //every mix of upper and lower case
+		  unsigned char c0=ranks[r], c1=suits[s];
+		  if (i&1 && c0>'9') c0|=32;
+		  if (i&2) c1|=32;
+		  ACE_cardcode[c0|c1<<8]=s*13+r+1;
+		  cards[s*13+r]=ACE_makecard(s*13+r);
+		}
+}
+
+void ACE_parse_text(ACE_parser *ps, const char *text, size_t size, int ncards){
+  memset(ps,0,sizeof(*ps));
+  ps->text=ps->p=text;
+  ps->size=size;
+  ps->end=text+size;
+  ps->ncards=ncards;
+}
+
+int ACE_parse_open(ACE_parser *ps, const char *path, int ncards){
+  struct stat st;
+  void *text;
+  int fd=open(path,O_RDONLY);
+  if (fd<0) return -1;
+  if (fstat(fd,&st)) { close(fd); return -1; }
+  text = st.st_size ? mmap(NULL,st.st_size,PROT_READ,MAP_PRIVATE,fd,0) : (void*)"";
+  close(fd);
+  if (text==MAP_FAILED) return -1;
+  if (st.st_size) madvise(text,st.st_size,MADV_SEQUENTIAL);
+  ACE_parse_text(ps,text,st.st_size,ncards);
+  ps->mapped=st.st_size>0;
+  return 0;
+}
+
+void ACE_parse_close(ACE_parser *ps){
+  if (ps->mapped) munmap((void*)ps->text,ps->size);
+  ps->mapped=0;
+}
+
+/* One line at a time: if the line goes bad, or won't fit, `n` goes back to where it began.
+   Hands and records share this body, which is inlined into each with `records` constant.*/
+static inline __attribute__((always_inline))
+size_t parse(ACE_parser *ps, Card hands[][ACEHAND], uint8_t records[][ACE_RECORD], size_t max){
+  const char *p=ps->p, *end=ps->end, *start;
+  size_t n=0, first;
+  int k, ncards=ps->ncards;
+  uint16_t pair;
+  Card *h=NULL;
+  uint8_t *r=NULL;
+
+  if (!max) return 0;
+  while (p<end && n<max) {
+	 start=p;
+	 first=n;
+	 k=0;
+	 for (;p<end && *p!='\n';p++) {
+		if (*p==' ' || *p=='\t' || *p=='\r' || *p==',') continue;
+		if (!k) {
+		  if (n==max) break;  //no room: leave this line for the next call
+		  if (records) {
+			 r=records[n++];
+			 memset(r,ACE_NOCARD,ACE_RECORD);
+		  }
+		  else {
+			 h=hands[n++];
+			 memset(h,0,sizeof(Card)*ACEHAND);
+		  }
+		}
+		if (p+1>=end) { k=-1; break; }
+		pair=ACE_cardcode[(unsigned char)p[0]|(unsigned char)p[1]<<8];
+		if (!pair) { k=-1; break; }
+		if (records) {
+		  if (k==ACE_RECORD) { k=-1; break; }
+		  r[k]=pair-1;
+		}
+		else
+		  ACE_addcard(h,cards[pair-1]);
+		p++;
+		if (++k==ncards) k=0;
+	 }
+	 if (p<end && *p!='\n' && k>=0) {  //out of room
+		if (first) { p=start; n=first; break; }
+		k=-1;                           //a line longer than the whole batch
+	 }
+	 if (k<0 || (ncards && k)) {        //bad card, or a hand left short
+		n=first;
+		ps->bad++;
+		if (!ps->firstbad) ps->firstbad=ps->line+1;
+		p=memchr(p,'\n',end-p);
+		if (!p) p=end;
+	 }
+	 if (p<end) p++;
+	 ps->line++;
+  }
+  ps->p=p;
+  return n;
+}
+
+size_t ACE_parse_hands(ACE_parser *ps, Card hands[][ACEHAND], size_t max){
+  return parse(ps,hands,NULL,max);
+}
+
+size_t ACE_parse_records(ACE_parser *ps, uint8_t records[][ACE_RECORD], size_t max){
+  return parse(ps,NULL,records,max);
+}
@@ -0,0 +1,50 @@
+/* Streaming card parser.
+ *
+ * Reads text like pokerhands.txt: cards as rank then suit ("AS", "td"), separated by
+ * spaces, one deal per line.  The file is mapped, not read, and the cards go straight
+ * into hands ready for `E`, a batch at a time, so nothing is allocated per line.
+ *
+ * Each line is cut into hands of `ncards` cards (5 for pokerhands.txt, 2 hands a line),
+ * or is one hand if ncards is 0.  A line's hands always come out together in one batch,
+ * so the n-th hand of a line is easy to find, and a call returns as soon as its batch
+ * is full, so a batch of one line's hands is exactly one line (after any bad ones).  A line with a bad card, or cards left
+ * over, is skipped and counted in `bad`.
+ *
+ * Each card is two bytes, looked up together in a 64K table of card numbers.
+ */
+#ifndef ACE_PARSE_H
+#define ACE_PARSE_H
+#include "ace_eval.h"
+
+typedef struct {
+  const char *p, *end;  //what's left to read
+  const char *text;     //the whole input
+  size_t size;
+  int mapped;
+  int ncards;
+  long line;            //lines read so far
+  long bad;             //lines skipped
+  long firstbad;        //line number of the first one, 0 if none
+} ACE_parser;
+
+/* Map a file. Returns 0, or -1 if it can't be opened or mapped*/
+extern int ACE_parse_open(ACE_parser *ps, const char *path, int ncards);
+
+/* Parse text that is already in memory*/
+extern void ACE_parse_text(ACE_parser *ps, const char *text, size_t size, int ncards);
+
+/* Fill up to `max` hands, returns how many. 0 means the input is done*/
+extern size_t ACE_parse_hands(ACE_parser *ps, Card hands[][ACEHAND], size_t max);
+
+/* The same, but each hand is a record of deck positions (0..51), ACE_NOCARD after the last.
+   A hand of more than ACE_RECORD cards makes its line bad*/
+#define ACE_RECORD 8
+#define ACE_NOCARD 0xFF
+extern size_t ACE_parse_records(ACE_parser *ps, uint8_t records[][ACE_RECORD], size_t max);
+
+extern void ACE_parse_close(ACE_parser *ps);
+
+/* Two bytes of text to deck position+1, 0 if it isn't a card.
+   Index with the first byte in the low 8 bits*/
+extern uint8_t ACE_cardcode[65536];
+#endif
@@ -0,0 +1,203 @@
+/* 7 card lookup table.
+   See ace_table.h
+*/
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ace_table.h"
+
+#define PAGE 4096
+
+/* A state: 3 bits of count for each rank, and 13 rank bits for each suit that can still
+   make a flush (all zero for the others)*/
+typedef struct {
+  uint64_t counts, suits;
+} state_t;
+
+typedef struct {
+  state_t *state;
+  uint8_t (*cards)[7];   //the first hand that reached each state
+  long n, size;
+  long *slot;            //hash of state number+1, 0 for empty
+  long nslots;
+} states_t;
+
+#define COUNT(s,r)  ((s).counts>>3*(r)&7)
+#define SUIT(s,u)   ((Card)((s).suits>>13*(u)&0x1FFF))
+
+/* A suit matters while its cards and the cards still to come could make 5*/
+static int live(state_t s, int u, int k){
+  return __builtin_popcount(SUIT(s,u))+7-k>=5;
+}
+
+static state_t forget(state_t s, int k){
+  int u;
+  for (u=0;u<4;u++)
+	 if (!live(s,u,k)) s.suits&=~(0x1FFFULL<<13*u);
+  return s;
+}
+
+static long hash(state_t s, long nslots){
+  return (s.counts*0x9E3779B97F4A7C15ULL ^ s.suits*0xC2B2AE3D27D4EB4FULL)>>17 & (nslots-1);
+}
+
+static int grow(states_t *t){
+  long i,j;
+  if (t->n==t->size) {
+	 void *state, *cards;
+	 long size=t->size ? 2*t->size : 1<<16;
+	 if (!(state=realloc(t->state,size*sizeof(state_t)))) return -1;
+	 t->state=state;
+	 if (!(cards=realloc(t->cards,size*sizeof(t->cards[0])))) return -1;
+	 t->cards=cards;
+	 t->size=size;
+  }
+  if (2*t->n>=t->nslots) {
+	 free(t->slot);
+	 t->nslots=t->nslots ? 2*t->nslots : 1<<17;
+	 if (!(t->slot=calloc(t->nslots,sizeof(long)))) return -1;
+	 for (i=0;i<t->n;i++) {
+		for (j=hash(t->state[i],t->nslots);t->slot[j];j=(j+1)&(t->nslots-1));
+		t->slot[j]=i+1;
+	 }
+  }
+  return 0;
+}
+
+/* The number of state s, added (with its hand) if it is new, or -1*/
+static long find(states_t *t, state_t s, const uint8_t cards[], int k){
+  long j;
+  if (grow(t)) return -1;
+  for (j=hash(s,t->nslots);t->slot[j];j=(j+1)&(t->nslots-1))
+	 if (t->state[t->slot[j]-1].counts==s.counts && t->state[t->slot[j]-1].suits==s.suits)
+		return t->slot[j]-1;
+  t->slot[j]=t->n+1;
+  t->state[t->n]=s;
+  memcpy(t->cards[t->n],cards,k);
+  return t->n++;
+}
+
+static int writeall(int fd, const void *buf, size_t n){
+  const char *p=buf;
+  ssize_t w;
+  while (n) {
+	 if ((w=write(fd,p,n))<=0) return -1;
+	 p+=w;
+	 n-=w;
+  }
+  return 0;
+}
+
+/* Breadth first from the empty hand: the states of k cards are numbered before any of k+1,
+   so each row can be filled in as its state is reached.*/
+long ACE_table_build(const char *path){
+  states_t t={0};
+  uint32_t *table=NULL, *grown;
+  static const char zeros[PAGE];
+  ACE_tablehead head={.magic=ACE_TABLEMAGIC, .version=1};
+  state_t s, next;
+  uint8_t cards[7]={0};
+  char *tmp=NULL;
+  long i, to, rows=0, ret=-1;
+  int k, c, u, r, e, fd, bad;
+
+  if (find(&t,(state_t){0,0},cards,0)<0) goto done;
+  for (i=0;i<t.n;i++) {
+	 s=t.state[i];
+	 for (k=0,r=0;r<13;r++) k+=COUNT(s,r);
+	 if (i==rows) {  //room for twice as many rows
+		rows=rows ? 2*rows : 1<<16;
+		if (!(grown=realloc(table,rows*52*sizeof(uint32_t)))) goto done;
+		table=grown;
+	 }
+	 memcpy(cards,t.cards[i],k);
+	 for (c=0;c<52;c++) {
+		table[i*52+c]=0;  //a card the hand already has
+		r=c%13;
+		u=c/13;
+		next=s;
+		if (COUNT(s,r)==4) continue;
+		if (live(s,u,k)) {
+		  if (SUIT(s,u)>>r&1) continue;
+		  next.suits|=1ULL<<(13*u+r);
+		  cards[k]=c;
+		}
+		else {
+		  //the suit is forgotten, so any forgotten suit without this rank will do
+		  for (e=0;e<4;e++) {
+			 cards[k]=e*13+r;
+			 if (!live(s,e,k) && !memchr(cards,cards[k],k)) break;
+		  }
+		}
+		next.counts+=1ULL<<3*r;
+		if (k==6) {
+		  Card h[ACEHAND]={0};
+		  for (e=0;e<7;e++) ACE_addcard(h,ACE_makecard(cards[e]));
+		  table[i*52+c]=E(h);
+		}
+		else {
+		  if ((to=find(&t,forget(next,k+1),cards,k+1))<0) goto done;
+		  table[i*52+c]=to*52;
+		}
+	 }
+  }
+
+  head.entries=t.n*52;
+  head.offset=PAGE;
+  //to path.tmp, renamed over path: truncating it would kill the processes that have it mapped
+  if (!(tmp=malloc(strlen(path)+5))) goto done;
+  strcat(strcpy(tmp,path),".tmp");
+  if ((fd=open(tmp,O_WRONLY|O_CREAT|O_TRUNC,0666))<0) goto done;
+  bad=writeall(fd,&head,sizeof(head)) || writeall(fd,zeros,PAGE-sizeof(head))
+		|| writeall(fd,table,head.entries*sizeof(uint32_t));
+  if (close(fd) | bad || rename(tmp,path)) {
+	 unlink(tmp);
+	 goto done;
+  }
+  ret=t.n;
+
+ done:
+  free(tmp);
+  free(table);
+  free(t.state);
+  free(t.cards);
+  free(t.slot);
+  return ret;
+}
+
+int ACE_table_open(ACE_table *t, const char *path){
+  struct stat st;
+  const ACE_tablehead *head;
+  int flags=MAP_SHARED, fd=open(path,O_RDONLY);
+  memset(t,0,sizeof(*t));
+  if (fd<0) return -1;
+  if (fstat(fd,&st) || st.st_size<PAGE) { close(fd); return -1; }
+#ifdef MAP_POPULATE
+  flags|=MAP_POPULATE;
+#endif
+  t->map=mmap(NULL,st.st_size,PROT_READ,flags,fd,0);
+  close(fd);
+  if (t->map==MAP_FAILED) { t->map=NULL; return -1; }
+  t->size=st.st_size;
+  head=t->map;
+  if (memcmp(head->magic,ACE_TABLEMAGIC,4) || head->version!=1 || head->offset%PAGE
+		|| head->offset>t->size || head->entries>(t->size-head->offset)/sizeof(uint32_t)) {
+	 ACE_table_close(t);
+	 return -1;
+  }
+  t->table=(const uint32_t*)((char*)t->map+head->offset);
+  t->entries=head->entries;
+#ifdef MADV_HUGEPAGE
+  madvise(t->map,t->size,MADV_HUGEPAGE);  //only a hint, file pages often can't be huge
+#endif
+  return 0;
+}
+
+void ACE_table_close(ACE_table *t){
+  if (t->map) munmap(t->map,t->size);
+  memset(t,0,sizeof(*t));
+}
@@ -0,0 +1,52 @@
+/* A 7 card lookup table, in the style of the Two-Plus-Two evaluator.
+ *
+ * The table is a state machine: each state is a row of 52 entries, one per card
+ * (0..51, as passed to ACE_makecard).  From the first row, follow the entry for each
+ * card in turn; after the 7th card the entry is the value `E` gives that hand.
+ * So a hand is 7 dependent loads, and nothing else.
+ *
+ * A state keeps only what can still matter: how many of each rank, and the ranks of
+ * the suits that could still make a flush.  Every other suit is forgotten, which is
+ * what keeps the table down to a few hundred thousand states.
+ *
+ * ACE_table_build generates it, with `E` as the oracle, and writes it to a file.
+ * It writes path.tmp and renames that over path, so a process that has the old file
+ * mapped keeps reading it.
+ * ACE_table_open maps the file read-only and shared, so every process that opens it
+ * uses the same copy in the page cache.  The pages are read in up front (MAP_POPULATE),
+ * and the kernel is asked for huge pages where it can back a file with them.
+ *
+ * The cards of a hand must be different: a repeated card walks off into a wrong state.
+ */
+#ifndef ACE_TABLE_H
+#define ACE_TABLE_H
+#include "ace_eval.h"
+
+#define ACE_TABLEMAGIC "ACE7"
+typedef struct {
+  char magic[4];     //ACE_TABLEMAGIC
+  uint32_t version;  //1
+  uint64_t entries;  //52 per state
+  uint64_t offset;   //of the table in the file, page aligned
+} ACE_tablehead;
+
+typedef struct {
+  const uint32_t *table;
+  uint64_t entries;
+  void *map;
+  size_t size;       //of the whole mapping
+} ACE_table;
+
+/* Returns the number of states, or -1*/
+extern long ACE_table_build(const char *path);
+
+/* Returns 0, or -1 if it can't be mapped or isn't a table file*/
+extern int ACE_table_open(ACE_table *t, const char *path);
+extern void ACE_table_close(ACE_table *t);
+
+/* The value of 7 cards, by number*/
+static inline Card ACE_table_eval(const ACE_table *t, const int c[7]){
+  const uint32_t *T=t->table;
+  return T[T[T[T[T[T[T[c[0]]+c[1]]+c[2]]+c[3]]+c[4]]+c[5]]+c[6]];
+}
+#endif
@@ -0,0 +1,109 @@
+/* Decoder speed test.
+   usage: decode_test [values]
+
+   Deals random 7 card hands, evaluates them, and times turning the values into text:
+   fixed width rows, length prefixed records, and snprintf as ace_decode.c does it.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ace_describe.h"
+
+#define WIDTH 48    //bytes per fixed width row
+#define CHUNK 4096  //values per call
+
+double seconds(void){
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC,&t);
+  return t.tv_sec+t.tv_nsec/1e9;
+}
+
+static const char *names[]= {
+  "Two","Three","Four","Five","Six","Seven","Eight","Nine","Ten","Jack","Queen","King","Ace"};
+
+//the ace_decode.c way, into a buffer
+int decode_printf(Card v, char *out){
+  const char *c[10];
+  int n=0,bit;
+  for (bit=26;bit-->0;)
+	 if (v>>bit&1) c[n++]=names[bit%13];
+  for (;n<5;n++) c[n]="";
+  switch (v>>28){
+  case 9: return sprintf(out,"Straight Flush, %s high",c[0]);
+  case 7: return sprintf(out,"4 of a Kind, %ss with a %s",c[0],c[1]);
+  case 6: return sprintf(out,"Full House, %ss over %ss",c[0],c[1]);
+  case 5: return sprintf(out,"Flush, %s %s %s %s %s",c[0],c[1],c[2],c[3],c[4]);
+  case 4: return sprintf(out,"Straight, %s high",c[0]);
+  case 3: return sprintf(out,"3 of a Kind, %ss over %s %s",c[0],c[1],c[2]);
+  case 2: return sprintf(out,"2 Pair, %ss and %ss with a %s",c[0],c[1],c[2]);
+  case 1: return sprintf(out,"Pair, %ss over %s %s %s",c[0],c[1],c[2],c[3]);
+  case 0: return sprintf(out,"High Card, %s with %s %s %s %s",c[0],c[1],c[2],c[3],c[4]);
+  }
+  return sprintf(out,"Error");
+}
+
+int main(int argc, char* argv[])
+{
+  long n = argc>1 ? atol(argv[1]) : 10000000, i, j, check=0;
+  Card *values = malloc(n*sizeof(Card)), deck[52];
+  static char rows[CHUNK*WIDTH], packed[CHUNK*(ACE_DECODE_MAX+1)];
+  static ACE_decoder d;
+  double start, fixed, prefixed, printed;
+  size_t used;
+  int k;
+
+  srand(1);
+  for (k=0;k<52;k++) deck[k]=ACE_makecard(k);
+  for (i=0;i<n;i++) {
+	 Card h[ACEHAND]={0};
+	 for (k=0;k<7;k++) {  //a partial shuffle, 7 cards deep
+		int r=k+rand()%(52-k);
+		Card c=deck[r]; deck[r]=deck[k]; deck[k]=c;
+		ACE_addcard(h,c);
+	 }
+	 values[i]=E(h);
+  }
+
+  start=seconds();
+  ACE_decoder_init(&d);
+  printf("decoder tables built in %.3f ms\n",(seconds()-start)*1e3);
+
+  //a few samples, one of each
+  {
+	 int seen[10]={0};
+	 char text[ACE_DECODE_MAX+1];
+	 for (i=0;i<n;i++)
+		if (!seen[ACE_rank(values[i])]++) {
+		  text[ACE_decode(&d,values[i],text)]=0;
+		  printf("  %08x  %s\n",values[i],text);
+		}
+  }
+
+  start=seconds();
+  for (i=0;i<n;i+=CHUNK) {
+	 j = n-i<CHUNK ? n-i : CHUNK;
+	 ACE_decode_fixed(&d,values+i,j,rows,WIDTH);
+	 check+=rows[0];
+  }
+  fixed=seconds()-start;
+
+  start=seconds();
+  for (i=0;i<n;i+=j) {
+	 j=ACE_decode_prefixed(&d,values+i,n-i<CHUNK ? n-i : CHUNK,packed,sizeof(packed),&used);
+	 check+=used;
+  }
+  prefixed=seconds()-start;
+
+  start=seconds();
+  for (i=0;i<n;i++)
+	 check+=decode_printf(values[i],rows);
+  printed=seconds()-start;
+
+  printf("\n%ld values\n",n);
+  printf("fixed width:     %.1f Mresults/s\n",n/fixed/1e6);
+  printf("length prefixed: %.1f Mresults/s\n",n/prefixed/1e6);
+  printf("sprintf:         %.1f Mresults/s\n",n/printed/1e6);
+  free(values);
+  return check==-1;
+}
@@ -0,0 +1,291 @@
+/* Differential test: every evaluator against a plain reference, on every hand.
+   usage: diff_test [-t threads] [-T table-file] [variant ...]
+
+   `make diff_test` links all the variants under their own names, as `make bench` does.
+   Every 5, 6 and 7 card hand is dealt with the enumeration engine (ace_enum.c),
+   and each variant is run on it, E_batch a block at a time, the rest hand by hand.
+   Every result is compared, all 32 bits, with `oracle` below, which counts ranks and suits
+   and picks the cards the slow obvious way, sharing no code with the evaluators.
+   The first few hands each variant gets wrong are printed, with both values.
+   Returns 1 if anything was wrong.
+
+   `table` is the lookup table from ace_table.c, in the file given with -T or $ACE_TABLEFILE,
+   which is built first if it isn't there (121MB).  Without either, `table` is skipped.  Each hand is looked up twice, in the order dealt and shuffled, since
+   the table must give the same value for any order of the same cards.
+
+   The golfed evaluator keeps its scratch in globals, so only one thread runs it at a time.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include "ace_eval.h"
+#include "ace_enum.h"
+#include "ace_eval_inline.h"
+#include "ace_table.h"
+
+#define SCALAR(v) extern Card E_##v(Card []);
+#define BATCH(v)  extern void E_batch_##v(const Card [][ACEHAND], Card [], size_t);
+SCALAR(golf) SCALAR(base) SCALAR(unroll) SCALAR(flushtable)
+SCALAR(decompress) SCALAR(branchless) SCALAR(hybrid)
+BATCH(avx2) BATCH(avx512)
+
+#define BLOCK 1024  //hands checked at a time
+#define SHOW  3     //wrong hands kept per variant and thread
+
+typedef struct {
+  const char *name;
+  int ncards;
+  Card (*eval)(Card []);
+  void (*batch)(const Card [][ACEHAND], Card [], size_t);
+  int needs;   //cpu feature
+  int locked;  //not thread safe
+  Card (*bycards)(const int [7]);  //takes deck positions instead
+} variant_t;
+enum {ANY, AVX2, AVX512};
+
+static ACE_table table;
+#define DISAGREE 0xFFFFFFFF  //not a value: the two orders gave different ones
+
+static Card table_eval(const int c[7]){
+  int s[7], i, j, t;
+  unsigned x=(c[0]*52+c[2])*52+c[4]+c[6]*7919;  //picks one of the 5040 orders
+  memcpy(s,c,sizeof(s));
+  for (i=6;i>0;i--) {
+	 j=x%(i+1);
+	 x/=i+1;
+	 t=s[i]; s[i]=s[j]; s[j]=t;
+  }
+  t=ACE_table_eval(&table,c);
+  return ACE_table_eval(&table,s)==(Card)t ? (Card)t : DISAGREE;
+}
+
+static const variant_t variants[]={
+  {"E5",5,E5},
+  {"E6",6,E6},
+  {"golf",7,E_golf,NULL,ANY,1},
+  {"base",7,E_base},
+  {"unroll",7,E_unroll},
+  {"flushtable",7,E_flushtable},
+  {"decompress",7,E_decompress},
+  {"branchless",7,E_branchless},
+  {"E7",7,E7},
+  {"hybrid",7,E_hybrid},
+  {"inline",7,ACE_eval},
+  {"batch",7,NULL,E_batch_avx2,AVX2},
+  {"batch512",7,NULL,E_batch_avx512,AVX512},
+  {"table",7,NULL,NULL,ANY,0,table_eval},
+};
+#define NVARIANTS (int)(sizeof(variants)/sizeof(variants[0]))
+static int on[NVARIANTS];
+static pthread_mutex_t lock=PTHREAD_MUTEX_INITIALIZER;
+
+typedef struct {
+  int cards[7];
+  Card got,want;
+} wrong_t;
+
+typedef struct {
+  int ncards, n;
+  long hands;
+  Card h[BLOCK][ACEHAND];
+  int cards[BLOCK][7];
+  Card want[BLOCK], got[BLOCK];
+  long bad[NVARIANTS];
+  wrong_t show[NVARIANTS][SHOW];
+  char pad[64];
+} acc_t;
+
+/* The top `j` ranks of mask m*/
+static Card highest(Card m, int j){
+  Card k=0;
+  for (;m && j>0;j--) {
+	 k|=1u<<(31-__builtin_clz(m));
+	 m&=~k;
+  }
+  return k;
+}
+
+/* The top card of the highest 5 ranks in a row of m, counting the ace low too, or -1*/
+static int straight(Card m){
+  int r;
+  m=m<<1|(m>>12&1);
+  for (r=12;r>=3;r--)
+	 if ((m>>(r-3)&31)==31) return r;
+  return -1;
+}
+
+/* The value of the best 5 of `n` cards, by deck position, built directly from the rules.*/
+static Card oracle(const int c[], int n){
+  int count[13]={0}, i, r, top;
+  Card suit[4]={0}, ranks=0, of[5]={0}, flush=0, trips, pairs;
+
+  for (i=0;i<n;i++) {
+	 count[c[i]%13]++;
+	 suit[c[i]/13]|=1u<<c[i]%13;
+  }
+  for (r=0;r<13;r++)
+	 of[count[r]]|=1u<<r;  //the ranks held exactly 1, 2, 3 or 4 times
+  ranks=of[1]|of[2]|of[3]|of[4];
+  for (i=0;i<4;i++)
+	 if (__builtin_popcount(suit[i])>=5) flush=suit[i];
+
+  if (flush && (top=straight(flush))>=0)
+	 return 9u<<28|1u<<top<<13;
+  if (of[4])
+	 return 7u<<28|of[4]<<13|highest(ranks^of[4],1);
+  if (of[3]) {
+	 trips=highest(of[3],1);
+	 pairs=of[2]|(of[3]^trips);
+	 if (pairs) return 6u<<28|trips<<13|highest(pairs,1);
+  }
+  if (flush)
+	 return 5u<<28|highest(flush,5)<<13;
+  if ((top=straight(ranks))>=0)
+	 return 4u<<28|1u<<top<<13;
+  if (of[3])
+	 return 3u<<28|of[3]<<13|highest(ranks^of[3],2);
+  if (__builtin_popcount(of[2])>=2) {
+	 pairs=highest(of[2],2);
+	 return 2u<<28|pairs<<13|highest(ranks^pairs,1);
+  }
+  if (of[2])
+	 return 1u<<28|of[2]<<13|highest(ranks^of[2],3);
+  return highest(ranks,5);
+}
+
+/* Run every variant for this hand size on the block, and compare*/
+static void check(acc_t *a){
+  int j,i;
+  for (i=0;i<a->n;i++)
+	 a->want[i]=oracle(a->cards[i],a->ncards);
+  for (j=0;j<NVARIANTS;j++) {
+	 const variant_t *v=&variants[j];
+	 if (!on[j] || v->ncards!=a->ncards) continue;
+	 if (v->locked) pthread_mutex_lock(&lock);
+	 if (v->batch)
+		v->batch((const Card (*)[ACEHAND])a->h,a->got,a->n);
+	 else if (v->bycards)
+		for (i=0;i<a->n;i++)
+		  a->got[i]=v->bycards(a->cards[i]);
+	 else
+		for (i=0;i<a->n;i++)
+		  a->got[i]=v->eval(a->h[i]);
+	 if (v->locked) pthread_mutex_unlock(&lock);
+	 for (i=0;i<a->n;i++)
+		if (a->got[i]!=a->want[i]) {
+		  if (a->bad[j]<SHOW) {
+			 wrong_t *w=&a->show[j][a->bad[j]];
+			 memcpy(w->cards,a->cards[i],sizeof(w->cards));
+			 w->got=a->got[i];
+			 w->want=a->want[i];
+		  }
+		  a->bad[j]++;
+		}
+  }
+  a->hands+=a->n;
+  a->n=0;
+}
+
+static void visit(void *acc, Card h[ACEHAND], const int cards[], int weight){
+  acc_t *a=acc;
+  memcpy(a->h[a->n],h,sizeof(Card[ACEHAND]));
+  memcpy(a->cards[a->n],cards,a->ncards*sizeof(int));
+  if (++a->n==BLOCK) check(a);
+}
+
+static void printcards(const int c[], int n){
+  int i;
+  for (i=0;i<n;i++)
+	 printf(" %c%c","23456789TJQKA"[c[i]%13],"CDHS"[c[i]/13]);
+}
+
+static int wanted(const variant_t *v, char *names[], int nnames){
+  int a;
+  __builtin_cpu_init();
+  if (v->needs==AVX2 && !__builtin_cpu_supports("avx2")) return 0;
+  if (v->needs==AVX512 && !__builtin_cpu_supports("avx512f")) return 0;
+  for (a=0;a<nnames;a++)
+	 if (!strcmp(names[a],v->name)) return 1;
+  return !nnames;
+}
+
+int main(int argc, char* argv[])
+{
+  int nthreads=ACE_ncpus(), nnames=0, ncards, a, t, j, w, any, failed=0;
+  char *names[64], *path=getenv("ACE_TABLEFILE");
+  Card deck[52], base[ACEHAND]={0};
+  acc_t *accs;
+  struct timespec start,end;
+
+  for (a=1;a<argc;a++)
+	 if (!strcmp(argv[a],"-t") && a+1<argc) nthreads=atoi(argv[++a]);
+	 else if (!strcmp(argv[a],"-T") && a+1<argc) path=argv[++a];
+	 else if (argv[a][0]!='-' && nnames<64) names[nnames++]=argv[a];
+	 else {
+		fprintf(stderr,"usage: diff_test [-t threads] [-T table-file] [variant ...]\n");
+		return 2;
+	 }
+  if (nthreads<1) nthreads=1;
+  for (j=0;j<NVARIANTS;j++)
+	 on[j]=wanted(&variants[j],names,nnames);
+  for (j=0;j<NVARIANTS;j++)
+	 if (on[j] && variants[j].bycards==table_eval) {
+		if (!path) {
+		  printf("skipping table: no -T table-file or ACE_TABLEFILE\n");
+		  on[j]=0;
+		}
+		else if (ACE_table_open(&table,path)) {
+		  printf("building %s\n",path);
+		  if (ACE_table_build(path)<0 || ACE_table_open(&table,path)) {
+			 perror(path);
+			 return 2;
+		  }
+		}
+	 }
+  for (a=0;a<52;a++)
+	 deck[a]=ACE_makecard(a);
+  if (!(accs=malloc(nthreads*sizeof(acc_t)))) return 2;
+
+  for (ncards=5;ncards<=7;ncards++) {
+	 for (any=0,j=0;j<NVARIANTS;j++)
+		any|=on[j] && variants[j].ncards==ncards;
+	 if (!any) continue;
+
+	 memset(accs,0,nthreads*sizeof(acc_t));
+	 for (t=0;t<nthreads;t++)
+		accs[t].ncards=ncards;
+	 clock_gettime(CLOCK_MONOTONIC,&start);
+	 if (ACE_enumerate(deck,52,base,ncards,nthreads,visit,accs,sizeof(acc_t))) return 2;
+	 for (t=0;t<nthreads;t++)
+		check(&accs[t]);  //the last part block
+	 clock_gettime(CLOCK_MONOTONIC,&end);
+	 for (t=1;t<nthreads;t++)
+		accs[0].hands+=accs[t].hands;
+	 printf("%d cards: %ld hands, %.2f seconds on %d threads\n",ncards,accs[0].hands,
+			  end.tv_sec-start.tv_sec+(end.tv_nsec-start.tv_nsec)/1e9,nthreads);
+
+	 for (j=0;j<NVARIANTS;j++) {
+		long bad=0;
+		if (!on[j] || variants[j].ncards!=ncards) continue;
+		for (t=0;t<nthreads;t++)
+		  bad+=accs[t].bad[j];
+		if (!bad) {
+		  printf("  %-12s ok\n",variants[j].name);
+		  continue;
+		}
+		failed=1;
+		printf("  %-12s %ld wrong\n",variants[j].name,bad);
+		for (t=0;t<nthreads;t++)
+		  for (w=0;w<accs[t].bad[j] && w<SHOW;w++) {
+			 printf("   ");
+			 printcards(accs[t].show[j][w].cards,ncards);
+			 printf(": %08x, should be %08x\n",accs[t].show[j][w].got,accs[t].show[j][w].want);
+		  }
+	 }
+  }
+  free(accs);
+  ACE_table_close(&table);
+  return failed;
+}
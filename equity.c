@@ -0,0 +1,94 @@
+/* Equity calculator.
+   usage: equity [-t threads] [-n deals] [-s seconds] [-r seed] ASKS QHQD ... [-b board] [-d dead]
+
+   Each hand is two cards, `xx` for two random ones, or `ASxx` for one.
+   The board (up to 5 cards) and the dead cards are written together: -b 2C7H9S
+   Two known hands with no -n or -s deal every runout for an exact answer.
+   Anything else is a Monte Carlo run, which reports each equity with its standard error.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ace_equity.h"
+#include "ace_enum.h"
+
+//read up to `max` cards written together, `xx` is a random card (-1). Returns the count, or -1.
+int parse_cards(const char* text, int cards[], int max)
+{
+  int n=0;
+  for (;*text;text+=2) {
+	 if (n==max || !text[1]) return -1;
+	 if ((text[0]=='x' || text[0]=='X') && text[0]==text[1])
+		cards[n++]=-1;
+	 else if ((cards[n++]=ACE_parsecard(text))<0)
+		return -1;
+  }
+  return n;
+}
+
+int main(int argc, char* argv[])
+{
+  int hole[ACE_MAXPLAYERS][2], board[5], dead[52];
+  int nplayers=0, nboard=0, ndead=0, nthreads=ACE_ncpus(), random=0;
+  long deals=0;
+  double seconds=0, ms;
+  uint64_t seed=time(NULL);
+  struct timespec start,end;
+  int i,p;
+
+  for (i=1;i<argc;i++) {
+	 int ok=1;
+	 if (!strcmp(argv[i],"-t") && i+1<argc) nthreads=atoi(argv[++i]);
+	 else if (!strcmp(argv[i],"-n") && i+1<argc) deals=atol(argv[++i]);
+	 else if (!strcmp(argv[i],"-s") && i+1<argc) seconds=atof(argv[++i]);
+	 else if (!strcmp(argv[i],"-r") && i+1<argc) seed=strtoull(argv[++i],NULL,0);
+	 else if (!strcmp(argv[i],"-b") && i+1<argc) ok=(nboard=parse_cards(argv[++i],board,5))>=0;
+	 else if (!strcmp(argv[i],"-d") && i+1<argc) ok=(ndead=parse_cards(argv[++i],dead,52))>=0;
+	 else if (nplayers<ACE_MAXPLAYERS) {
+		ok=parse_cards(argv[i],hole[nplayers],2)>=0;
+		if (strlen(argv[i])==2) hole[nplayers][1]=-1;
+		random+=(hole[nplayers][0]<0)+(hole[nplayers][1]<0);
+		nplayers++;
+	 }
+	 else ok=0;
+	 if (!ok || nboard<0 || ndead<0) {
+		fprintf(stderr,"bad argument: %s\n",argv[i]);
+		return 1;
+	 }
+  }
+  if (nplayers<2) {
+	 fprintf(stderr,"usage: %s [-t threads] [-n deals] [-s seconds] [-r seed] ASKS QHQD ... [-b board] [-d dead]\n",argv[0]);
+	 return 1;
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  if (nplayers==2 && !random && !deals && seconds<=0 && !ndead) {
+	 ACE_showdown s;
+	 double total;
+	 if (ACE_equity_hu(hole[0],hole[1],board,nboard,nthreads,&s)) {
+		fprintf(stderr,"repeated card\n");
+		return 1;
+	 }
+	 clock_gettime(CLOCK_MONOTONIC, &end);
+	 ms = (end.tv_sec-start.tv_sec)*1e3 + (end.tv_nsec-start.tv_nsec)/1e6;
+	 total = s.win+s.lose+s.tie;
+	 printf("win:  %ld\nlose: %ld\ntie:  %ld\n", s.win, s.lose, s.tie);
+	 printf("equity: %.4f\n", (s.win+s.tie/2.0)/total);
+	 printf("%.0f boards in %.2f ms on %d threads\n", total, ms, nthreads);
+  }
+  else {
+	 ACE_equity e;
+	 if (!deals && seconds<=0) deals=1000000;
+	 if (ACE_equity_mc(nplayers,hole,board,nboard,dead,ndead,deals,seconds,nthreads,seed,&e)) {
+		fprintf(stderr,"repeated card, or not enough cards left\n");
+		return 1;
+	 }
+	 clock_gettime(CLOCK_MONOTONIC, &end);
+	 ms = (end.tv_sec-start.tv_sec)*1e3 + (end.tv_nsec-start.tv_nsec)/1e6;
+	 for (p=0;p<nplayers;p++)
+		printf("player %d: %.4f +- %.4f\n", p+1, e.equity[p], e.error[p]);
+	 printf("%ld deals in %.2f ms on %d threads\n", e.deals, ms, nthreads);
+  }
+  return 0;
+}
@@ -0,0 +1,165 @@
+/* Head to head resolver for files like pokerhands.txt (Project Euler 54):
+   each line is two 5 card hands, player 1 then player 2.
+   usage: euler [-t threads] hands.txt [winners]
+
+   Prints how many lines each player wins, and the draws.  With a `winners` file,
+   it also writes one line per input line: 1, 2, D for a draw, or X for a bad or blank line.
+   A line with one hand, or more than two, is bad.
+   The file is mapped and cut into one block per thread at line boundaries, and the
+   blocks' answers are written out in order.
+*/
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "ace_parse.h"
+#include "ace_enum.h"
+
+typedef struct {
+  pthread_t thread;
+  const char *text;
+  size_t size;
+  long wins[3];    //player 1, player 2, draw
+  long lines, bad;
+  char *out;       //2 bytes per line, if asked for
+  size_t nout, room;
+  int nomem;       //the out buffer couldn't grow
+} block_t;
+
+void* resolve(void* arg)
+{
+  block_t* b = arg;
+  ACE_parser ps;
+  Card hands[2][ACEHAND];
+  const char *end=b->text+b->size, *eol;
+  size_t n;
+  char w, *grown;
+
+  ACE_parse_text(&ps,b->text,b->size,5);
+  while (ps.p<end) {
+	 //one line per call, so both hands come from the same line
+	 eol=memchr(ps.p,'\n',end-ps.p);
+	 ps.end = eol ? eol+1 : end;
+	 if ((n=ACE_parse_hands(&ps,hands,2))==2) {
+		Card p1=E(hands[0]), p2=E(hands[1]);
+		w = p1>p2 ? 0 : p1<p2 ? 1 : 2;
+		b->wins[(int)w]++;
+		w="12D"[(int)w];
+	 }
+	 else {
+		if (n) b->bad++;  //one hand: the parser takes it, but it is no pair
+		w='X';
+	 }
+	 if (b->room) {
+		if (b->nout+2 > b->room) {
+		  if (!(grown=realloc(b->out,b->room*2))) {
+			 b->nomem=1;
+			 break;
+		  }
+		  b->out=grown;
+		  b->room*=2;
+		}
+		b->out[b->nout++]=w;
+		b->out[b->nout++]='\n';
+	 }
+  }
+  b->lines=ps.line;
+  b->bad+=ps.bad;
+  return NULL;
+}
+
+int main(int argc, char* argv[])
+{
+  int nthreads=ACE_ncpus(), t, started, fd=-1;
+  ACE_parser file;
+  block_t* blocks;
+  const char *p, *end;
+  long wins[3]={0}, lines=0, bad=0;
+  struct timespec start,stop;
+  double sec;
+
+  if (argc>2 && !strcmp(argv[1],"-t")) {
+	 nthreads=atoi(argv[2]);
+	 argc-=2; argv+=2;
+  }
+  if (argc<2 || argc>3) {
+	 fprintf(stderr,"usage: euler [-t threads] hands.txt [winners]\n");
+	 return 1;
+  }
+  if (nthreads<1) nthreads=1;
+  if (ACE_parse_open(&file,argv[1],5)) {
+	 perror(argv[1]);
+	 return 1;
+  }
+  if (argc==3 && (fd=open(argv[2],O_WRONLY|O_CREAT|O_TRUNC,0666))<0) {
+	 perror(argv[2]);
+	 return 1;
+  }
+
+  clock_gettime(CLOCK_MONOTONIC,&start);
+  //cut the text into blocks, each ending just after a newline
+  if (!(blocks=calloc(nthreads,sizeof(block_t)))) {
+	 fprintf(stderr,"euler: out of memory\n");
+	 return 1;
+  }
+  p=file.text;
+  end=file.text+file.size;
+  for (t=0;t<nthreads;t++) {
+	 const char *cut = t==nthreads-1 ? end : file.text+file.size/nthreads*(t+1);
+	 if (cut<p) cut=p;
+	 if (cut<end) {
+		cut=memchr(cut,'\n',end-cut);
+		cut = cut ? cut+1 : end;
+	 }
+	 blocks[t].text=p;
+	 blocks[t].size=cut-p;
+	 if (fd>=0) {
+		blocks[t].room=blocks[t].size/15+64;  //about 2 bytes out per 30 in
+		if (!(blocks[t].out=malloc(blocks[t].room))) {
+		  fprintf(stderr,"euler: out of memory\n");
+		  break;
+		}
+	 }
+	 p=cut;
+	 if ((errno=pthread_create(&blocks[t].thread,NULL,resolve,&blocks[t]))) {
+		perror("euler: pthread_create");
+		break;
+	 }
+  }
+  if ((started=t)<nthreads) {
+	 //join only the threads that were started
+	 for (t=0;t<started;t++) pthread_join(blocks[t].thread,NULL);
+	 return 1;
+  }
+  for (t=0;t<nthreads;t++) {
+	 pthread_join(blocks[t].thread,NULL);
+	 if (blocks[t].nomem) {
+		fprintf(stderr,"euler: out of memory\n");
+		return 1;
+	 }
+	 if (fd>=0 && write(fd,blocks[t].out,blocks[t].nout)!=(ssize_t)blocks[t].nout) {
+		perror(argv[2]);
+		return 1;
+	 }
+	 wins[0]+=blocks[t].wins[0];
+	 wins[1]+=blocks[t].wins[1];
+	 wins[2]+=blocks[t].wins[2];
+	 lines+=blocks[t].lines;
+	 bad+=blocks[t].bad;
+	 free(blocks[t].out);
+  }
+  clock_gettime(CLOCK_MONOTONIC,&stop);
+  sec=stop.tv_sec-start.tv_sec+(stop.tv_nsec-start.tv_nsec)/1e9;
+
+  printf("1:%ld\n2:%ld\nD:%ld\n",wins[0],wins[1],wins[2]);
+  printf("%ld lines, %ld bad, %d threads, %.1f MB/s, %.1f Mlines/s\n",
+			lines,bad,nthreads,file.size/sec/1e6,lines/sec/1e6);
+  if (fd>=0) close(fd);
+  ACE_parse_close(&file);
+  free(blocks);
+  return 0;
+}
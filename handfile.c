@@ -0,0 +1,99 @@
+/* Hand file tool.
+   usage: handfile -c [-n cards] hands.txt hands.ace   convert text to a hand file
+          handfile hands.ace [results]                 evaluate it, and save the results
+
+   The results are a plain array of 32 bit `E` values, one per hand, in the same order.
+   Cards per hand defaults to 5, as in pokerhands.txt; 0 makes each line one hand.
+*/
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#include "ace_handfile.h"
+
+const char HandRanks[][16] = {"High Card","Pair","Two Pair","Three of a Kind","Straight","Flush","Full House","Four of a Kind","BAD","Straight Flush"};
+
+double seconds(void){
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC,&t);
+  return t.tv_sec+t.tv_nsec/1e9;
+}
+
+int convert(const char *text, const char *out, int ncards)
+{
+  long n,bad;
+  double start=seconds();
+  if ((n=ACE_handfile_convert(text,out,ncards,&bad))<0) {
+	 perror(out);
+	 return 1;
+  }
+  printf("%ld hands, %ld bad lines, %ld bytes, %.2f s\n", n, bad,
+			(long)sizeof(ACE_handhead)+n*ACE_RECORD, seconds()-start);
+  return 0;
+}
+
+int evaluate(const char *path, const char *save)
+{
+  ACE_handfile f;
+  long handTypeSum[10]={0};
+  Card *out;
+  size_t i, bytes;
+  double start, time;
+  int fd=-1;
+
+  if (ACE_handfile_open(&f,path)) {
+	 fprintf(stderr,"%s: not a hand file\n",path);
+	 return 1;
+  }
+  bytes=f.count*sizeof(Card);
+  if (save) {  //evaluate straight into the mapped results file
+	 if ((fd=open(save,O_RDWR|O_CREAT|O_TRUNC,0666))<0 || ftruncate(fd,bytes)) {
+		perror(save);
+		return 1;
+	 }
+	 out = bytes ? mmap(NULL,bytes,PROT_READ|PROT_WRITE,MAP_SHARED,fd,0) : NULL;
+  }
+  else
+	 out = bytes ? mmap(NULL,bytes,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0) : NULL;
+  if (out==MAP_FAILED) {
+	 perror("results");
+	 return 1;
+  }
+
+  start=seconds();
+  ACE_handfile_eval(&f,0,f.count,out);
+  time=seconds()-start;
+
+  for (i=0;i<f.count;i++)
+	 handTypeSum[ACE_rank(out[i])]++;
+  for (i=0;i<=9;i++)
+	 printf("%16s = %ld\n", HandRanks[i], handTypeSum[i]);
+  printf("%zu hands of %d cards, %.1f Mhands/s, %.1f MB/s\n", f.count, f.head->ncards,
+			f.count/time/1e6, f.size/time/1e6);
+
+  if (bytes) munmap(out,bytes);
+  if (fd>=0) close(fd);
+  ACE_handfile_close(&f);
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  int ncards=5;
+  if (argc>1 && !strcmp(argv[1],"-c")) {
+	 argc--; argv++;
+	 if (argc>2 && !strcmp(argv[1],"-n")) {
+		ncards=atoi(argv[2]);
+		argc-=2; argv+=2;
+	 }
+	 if (argc==3) return convert(argv[1],argv[2],ncards);
+  }
+  else if (argc==2 || argc==3)
+	 return evaluate(argv[1],argc==3 ? argv[2] : NULL);
+  fprintf(stderr,"usage: handfile -c [-n cards] hands.txt hands.ace\n"
+			"       handfile hands.ace [results]\n");
+  return 1;
+}
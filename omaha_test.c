@@ -0,0 +1,90 @@
+/* Omaha test.
+   usage: omaha_test [hands]
+
+   Deals random Omaha hands, 4 hole cards on boards of 3, 4 and 5, and checks ACE_omaha
+   against the brute force way: every 2 hole cards with every 3 board cards, through E5.
+   Then times both on the 5 card boards.
+   Returns 1 if any hand was wrong.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ace_omaha.h"
+
+double seconds(void){
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC,&t);
+  return t.tv_sec+t.tv_nsec/1e9;
+}
+
+/* The best of the 2 hole cards and 3 board cards hands*/
+static Card brute(const Card hole[4], const Card board[], int nboard){
+  Card best=0, v;
+  int a,b,x,y,z;
+  for (a=0;a<4;a++)
+	 for (b=a+1;b<4;b++)
+		for (x=0;x<nboard;x++)
+		  for (y=x+1;y<nboard;y++)
+			 for (z=y+1;z<nboard;z++) {
+				Card h[ACEHAND]={0};
+				ACE_addcard(h,hole[a]);
+				ACE_addcard(h,hole[b]);
+				ACE_addcard(h,board[x]);
+				ACE_addcard(h,board[y]);
+				ACE_addcard(h,board[z]);
+				if ((v=E5(h))>best) best=v;
+			 }
+  return best;
+}
+
+/* 4 hole cards then `nboard` board cards, from a partial shuffle*/
+static void deal(Card deck[52], int nboard){
+  int k;
+  for (k=0;k<4+nboard;k++) {
+	 int r=k+rand()%(52-k);
+	 Card c=deck[r]; deck[r]=deck[k]; deck[k]=c;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  long n = argc>1 ? atol(argv[1]) : 1000000, i, bad=0, check=0;
+  Card deck[52], (*hands)[9] = malloc(n*sizeof(*hands)), got, want;
+  double start, fast, slow;
+  int k, nboard;
+
+  if (!hands) return 2;
+  srand(1);
+  for (k=0;k<52;k++) deck[k]=ACE_makecard(k);
+
+  for (nboard=3;nboard<=5;nboard++) {
+	 long wrong=0;
+	 for (i=0;i<n;i++) {
+		deal(deck,nboard);
+		memcpy(hands[i],deck,sizeof(hands[i]));
+		got=ACE_omaha(hands[i],hands[i]+4,nboard);
+		want=brute(hands[i],hands[i]+4,nboard);
+		if (got!=want && wrong++<3)
+		  printf("  %08x, should be %08x\n",got,want);
+	 }
+	 printf("%d card board: %ld hands, %ld wrong\n",nboard,n,wrong);
+	 bad+=wrong;
+  }
+
+  //the 5 card boards are still in `hands`
+  start=seconds();
+  for (i=0;i<n;i++)
+	 check+=ACE_omaha(hands[i],hands[i]+4,5);
+  fast=seconds()-start;
+
+  start=seconds();
+  for (i=0;i<n;i++)
+	 check-=brute(hands[i],hands[i]+4,5);
+  slow=seconds()-start;
+
+  printf("\nACE_omaha:      %7.1f ns/hand\n",fast*1e9/n);
+  printf("60 calls to E5: %7.1f ns/hand\n",slow*1e9/n);
+  free(hands);
+  return bad>0 || check;
+}
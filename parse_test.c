@@ -0,0 +1,67 @@
+/* Parser speed test.
+   usage: parse_test [-n cards] file
+
+   Reads the file twice: once just parsing, and once parsing and evaluating each hand.
+   Cards per hand defaults to 5, as in pokerhands.txt; 0 makes each line one hand.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ace_parse.h"
+
+#define BATCH 1024  //hands per ACE_parse_hands call
+
+const char HandRanks[][16] = {"High Card","Pair","Two Pair","Three of a Kind","Straight","Flush","Full House","Four of a Kind","BAD","Straight Flush"};
+
+double seconds(void){
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC,&t);
+  return t.tv_sec+t.tv_nsec/1e9;
+}
+
+int main(int argc, char* argv[])
+{
+  static Card hands[BATCH][ACEHAND];
+  ACE_parser ps;
+  long handTypeSum[10]={0}, total=0, check=0;
+  int ncards=5, i, pass;
+  double start, time[2];
+  size_t n, j;
+
+  if (argc>2 && !strcmp(argv[1],"-n")) {
+	 ncards=atoi(argv[2]);
+	 argc-=2; argv+=2;
+  }
+  if (argc<2) {
+	 fprintf(stderr,"usage: parse_test [-n cards] file\n");
+	 return 1;
+  }
+
+  for (pass=0;pass<2;pass++) {
+	 if (ACE_parse_open(&ps,argv[1],ncards)) {
+		perror(argv[1]);
+		return 1;
+	 }
+	 start=seconds();
+	 total=0;
+	 while ((n=ACE_parse_hands(&ps,hands,BATCH))) {
+		total+=n;
+		if (!pass)
+		  check+=hands[n-1][3];  //so the parse isn't optimized away
+		else
+		  for (j=0;j<n;j++)
+			 handTypeSum[ACE_rank(ACE_evaluate(hands[j]))]++;
+	 }
+	 time[pass]=seconds()-start;
+	 ACE_parse_close(&ps);
+  }
+
+  for (i=0;i<=9;i++)
+	 printf("%16s = %ld\n", HandRanks[i], handTypeSum[i]);
+  printf("%ld hands from %ld lines, %ld bad lines", total, ps.line, ps.bad);
+  if (ps.bad) printf(" (first at line %ld)", ps.firstbad);
+  printf("\n\nparse:        %.1f MB/s, %.1f Mhands/s\n", ps.size/time[0]/1e6, total/time[0]/1e6);
+  printf("parse + eval: %.1f MB/s, %.1f Mhands/s\n", ps.size/time[1]/1e6, total/time[1]/1e6);
+  return check==-1;
+}
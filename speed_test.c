@@ -1,8 +1,11 @@
+#include <errno.h>
 #include <stdio.h>
 #include <time.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
+#include <unistd.h>
 
 //: Based on code collected in the XPokerEval library at:
 // http://www.codingthewheel.com/archives/poker-hand-evaluator-roundup
@@ -13,9 +16,20 @@ typedef int64_t LARGE_INTEGER;
 typedef struct timespec sysTime_t;
 
 #include "ace_eval.h"
+#ifdef ACE_INLINE
+#include "ace_eval_inline.h"  //also time ACE_eval, compiled into the loop
+#endif
+#ifdef ACE_TABLE
+#include "ace_table.h"        //`speed_test -t` times the lookup table against E
+#endif
 
 #define MS_PER_SEC 1000.0f
 #define LOTS  100000000 //1e6
+#define BATCH 1024  //hands per E_batch call
+#define STREAM (LOTS/10) //hands per working set size in `speed_test -s`
+#ifndef NCARDS
+#define NCARDS 7    //cards per hand
+#endif
 
 
 struct timespec timings,endtimings;
@@ -56,8 +70,257 @@ double platformSysTimeToMs(sysTime_t timeIn) {
     return (double)timeIn.tv_sec* MS_PER_SEC + (double)timeIn.tv_nsec / 1e6;
 }
 
-//Eval LOTS of random hands
-Card hands[LOTS][ACEHAND]={0};
+//Eval LOTS of random hands, or a ring of them in streaming mode
+Card (*hands)[ACEHAND];
+
+//Deal n hands of NCARDS, carrying on through the shuffled deck
+void dealHands(Card (*h)[ACEHAND], long n, Card* Deck, int* cardsLeft)
+{
+	long i;
+	int k;
+	for (i=0;i<n;i++)
+	{
+		if (*cardsLeft<NCARDS)
+		{
+			Shuffle(Deck);
+			*cardsLeft=52;
+		}
+		memset(h[i],0,sizeof(Card)*ACEHAND);
+		for (k=0;k<NCARDS;k++)
+		{
+			--*cardsLeft;
+			ACE_addcard(h[i],Deck[*cardsLeft]);
+		}
+	}
+}
+
+//Evaluate hands[first..last), counting hand types. Returns the number of hands.
+long evalHands(long first, long last, int* handTypeSum)
+{
+	long i;
+#ifdef ACE_BATCH
+	for (i=first;i<last;i+=BATCH)
+	{
+	  Card r[BATCH];
+	  int j,n = last-i<BATCH ? last-i : BATCH;
+	  E_batch( hands+i, r, n );
+	  for (j=0;j<n;j++)
+		 handTypeSum[ACE_rank(r[j])]++;
+	}
+#else
+	for (i=first;i<last;i++)
+	{
+	  Card r = ACE_evaluate( hands[i] );
+	  handTypeSum[ACE_rank(r)]++;
+	}
+#endif
+	return last-first;
+}
+
+#ifdef ACE_INLINE
+//The same loop, with the evaluator inlined instead of called
+long evalHandsInline(long first, long last, int* handTypeSum)
+{
+	long i;
+	for (i=first;i<last;i++)
+	{
+	  Card r = ACE_eval( hands[i] );
+	  handTypeSum[ACE_rank(r)]++;
+	}
+	return last-first;
+}
+#endif
+
+//** Multi-threaded timing: each thread takes its own slice of hands[] **/
+typedef struct {
+	pthread_t thread;
+	long first,last;
+	int handTypeSum[10];
+	double ms;            //thread cpu time
+	char pad[64];         //keep neighbouring slices off each other's cache lines
+} slice_t;
+
+void* evalSlice(void* arg)
+{
+	slice_t* s = arg;
+	sysTime_t start,end;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+	evalHands(s->first, s->last, s->handTypeSum);
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+	s->ms = platformSysTimeToMs(platformTimeElapsed(end,start));
+	return NULL;
+}
+
+int timeThreads(int nthreads)
+{
+	slice_t* slices = calloc(nthreads, sizeof(slice_t));
+	int handTypeSum[10]={0};
+	sysTime_t start,end;
+	double wall,cpu=0;
+	int t,i;
+
+	if (!slices)
+	{
+	  printf("out of memory\n");
+	  return 1;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (t=0;t<nthreads;t++)
+	{
+	  slices[t].first = LOTS/nthreads*t;
+	  slices[t].last = t==nthreads-1 ? LOTS : LOTS/nthreads*(t+1);
+	  if ((errno = pthread_create(&slices[t].thread, NULL, evalSlice, &slices[t])))
+	  {
+		 perror("pthread_create");
+		 while (t-->0) pthread_join(slices[t].thread, NULL);  //the ones already running
+		 free(slices);
+		 return 1;
+	  }
+	}
+	for (t=0;t<nthreads;t++)
+	{
+	  pthread_join(slices[t].thread, NULL);
+	  for (i=0;i<=9;i++)
+		 handTypeSum[i]+=slices[t].handTypeSum[i];
+	  cpu+=slices[t].ms;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	wall = platformSysTimeToMs(platformTimeElapsed(end,start));
+
+	for (i = 0; i <= 9; i++)			  // display results
+	  printf("\n%16s = %d", HandRanks[i], handTypeSum[i]);
+	printf("\nTotal Hands = %d\n", LOTS);
+
+	printf("\nThreads = %d\nWall seconds = %.4lf\nThread CPU seconds = %.4lf\n",
+			 nthreads, wall/1000, cpu/1000);
+	printf("\n %lf Mhands/sec aggregate\n", LOTS/(wall/1000)/1000000.0);
+	printf(" %lf Mhands/sec per core\n", LOTS/(cpu/1000)/1000000.0);
+	free(slices);
+	return 0;
+}
+
+
+//** Streaming: deal into a ring that fits in one cache level, evaluate it, deal again **/
+//Only the evaluation is timed, and the ring stays in that cache while it is refilled.
+long cacheSize(int name, long otherwise)
+{
+	long n = sysconf(name);
+	return n>0 ? n : otherwise;
+}
+
+int timeStream(Card* Deck, int* cardsLeft)
+{
+	const char* level[] = {"L1","L2","L3"};
+	long bytes[3] = {
+	  cacheSize(_SC_LEVEL1_DCACHE_SIZE, 32<<10),
+	  cacheSize(_SC_LEVEL2_CACHE_SIZE, 1<<20),
+	  cacheSize(_SC_LEVEL3_CACHE_SIZE, 8<<20)};
+	int handTypeSum[10], c;
+	long ring, done;
+	double ms;
+	sysTime_t start,end;
+
+	for (c=0;c<3;c++)
+	{
+	  ring = bytes[c]/2/sizeof(Card[ACEHAND]);  //half the cache, to leave room for the rest
+	  if (!(hands = malloc(ring*sizeof(Card[ACEHAND])))) return 1;
+	  memset(handTypeSum,0,sizeof(handTypeSum));
+	  for (ms=0,done=0;done<STREAM;done+=ring)
+	  {
+		 dealHands(hands, ring, Deck, cardsLeft);
+		 clock_gettime(CLOCK_MONOTONIC, &start);
+		 evalHands(0, ring, handTypeSum);
+		 clock_gettime(CLOCK_MONOTONIC, &end);
+		 ms += platformSysTimeToMs(platformTimeElapsed(end,start));
+	  }
+	  printf("%s %8ld KB ring %9ld hands %10.3lf ns/hand %9.2lf Mhands/sec\n",
+			 level[c], ring*sizeof(Card[ACEHAND])>>10, ring, ms*1e6/done, done/(ms/1000)/1000000.0);
+	  free(hands);
+	}
+	return 0;
+}
+
+#ifdef ACE_TABLE
+//** Lookup table against E: the same random hands, then every hand in order **/
+double threadMs(sysTime_t start)
+{
+	sysTime_t end;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+	return platformSysTimeToMs(platformTimeElapsed(end,start));
+}
+
+int timeTable(const char* path)
+{
+	ACE_table table;
+	const uint32_t* T;
+	Card ids[52], sumE=0, sumT=0, h[7][ACEHAND]={{0}};
+	int (*cards)[7];
+	long i, n=STREAM;
+	int k, c[7], left=0;
+	sysTime_t start;
+	double ms;
+
+	if (ACE_table_open(&table, path))
+	{
+	  printf("building %s\n", path);
+	  if (ACE_table_build(path)<0 || ACE_table_open(&table, path)) return 1;
+	}
+	T = table.table;
+	printf("%lu MB table\n", (unsigned long)(table.entries*4>>20));
+
+	//random: deal card numbers, and the same hands for E
+	hands = malloc(n*sizeof(Card[ACEHAND]));
+	cards = malloc(n*sizeof(cards[0]));
+	if (!hands || !cards) return 1;
+	for (i=0;i<52;i++) ids[i]=i;
+	for (i=0;i<n;i++)
+	{
+	  if (left<7) { Shuffle(ids); left=52; }
+	  memset(hands[i],0,sizeof(Card)*ACEHAND);
+	  for (k=0;k<7;k++)
+	  {
+		 cards[i][k]=ids[--left];
+		 ACE_addcard(hands[i],ACE_makecard(cards[i][k]));
+	  }
+	}
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+	for (i=0;i<n;i++) sumE+=ACE_evaluate(hands[i]);
+	ms=threadMs(start);
+	printf("random      E     %8.3lf ns/hand %9.2lf Mhands/sec\n", ms*1e6/n, n/ms/1000);
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+	for (i=0;i<n;i++) sumT+=ACE_table_eval(&table, cards[i]);
+	ms=threadMs(start);
+	printf("random      table %8.3lf ns/hand %9.2lf Mhands/sec%s\n", ms*1e6/n, n/ms/1000,
+			 sumE==sumT ? "" : "  (WRONG)");
+	free(cards);
+	free(hands);
+
+	//sequential: every 7 card hand, each loop carrying its partial hand or state down
+	n=133784560;
+	sumE=sumT=0;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+#define LEVEL(j) for (c[j]=j ? c[j-1]+1 : 0;c[j]<46+j;c[j]++)
+#define ADD(j) memcpy(h[j],h[j-1],sizeof(h[j])), ACE_addcard(h[j],ACE_makecard(c[j]))
+	LEVEL(0) { memset(h[0],0,sizeof(h[0])); ACE_addcard(h[0],ACE_makecard(c[0]));
+	LEVEL(1) { ADD(1); LEVEL(2) { ADD(2); LEVEL(3) { ADD(3); LEVEL(4) { ADD(4); LEVEL(5) { ADD(5);
+	LEVEL(6) { ADD(6); sumE+=ACE_evaluate(h[6]); }}}}}}}
+	ms=threadMs(start);
+	printf("sequential  E     %8.3lf ns/hand %9.2lf Mhands/sec\n", ms*1e6/n, n/ms/1000);
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+	{
+	  uint32_t p[7];
+	  LEVEL(0) { p[0]=T[c[0]];
+	  LEVEL(1) { p[1]=T[p[0]+c[1]]; LEVEL(2) { p[2]=T[p[1]+c[2]]; LEVEL(3) { p[3]=T[p[2]+c[3]];
+	  LEVEL(4) { p[4]=T[p[3]+c[4]]; LEVEL(5) { p[5]=T[p[4]+c[5]];
+	  LEVEL(6) sumT+=T[p[5]+c[6]]; }}}}}}
+	}
+	ms=threadMs(start);
+	printf("sequential  table %8.3lf ns/hand %9.2lf Mhands/sec%s\n", ms*1e6/n, n/ms/1000,
+			 sumE==sumT ? "" : "  (WRONG)");
+	ACE_table_close(&table);
+	return 0;
+}
+#endif
 
 
 int main(int argc, char*argv[])
@@ -66,7 +329,7 @@ int main(int argc, char*argv[])
 	Card Deck[52];
 	int cardsLeft = 52;
 
-	int count = 0;
+	int count = 0, nthreads = 0;
 	int handTypeSum[10]={0};
 
 	srand(argc);
@@ -77,43 +340,58 @@ int main(int argc, char*argv[])
 	}
 	Shuffle(Deck);
 
-	
-	for (i=0;i<LOTS;i++)
+//`speed_test -s` streams through cache sized rings instead of the 2GB array
+	if (argc>1 && !strcmp(argv[1],"-s"))
+	  return timeStream(Deck, &cardsLeft);
+#ifdef ACE_TABLE
+//`speed_test -t file` compares the lookup table with E, building the file if it isn't there.
+//The file can also come from $ACE_TABLEFILE; it is 121MB, so there is no default
+	if (argc>1 && !strcmp(argv[1],"-t"))
 	{
-		if (cardsLeft<7)
-		{
-			Shuffle(Deck);
-			cardsLeft=52;
-		}
-		memset(hands[i],0,sizeof(Card)*ACEHAND);
-		--cardsLeft;
-		ACE_addcard(hands[i],Deck[cardsLeft]);
-		--cardsLeft;
-		ACE_addcard(hands[i],Deck[cardsLeft]);
-		--cardsLeft;
-		ACE_addcard(hands[i],Deck[cardsLeft]);
-		--cardsLeft;
-		ACE_addcard(hands[i],Deck[cardsLeft]);
-		--cardsLeft;
-		ACE_addcard(hands[i],Deck[cardsLeft]);
-		--cardsLeft;
-		ACE_addcard(hands[i],Deck[cardsLeft]);
-		--cardsLeft;
-		ACE_addcard(hands[i],Deck[cardsLeft]);
+	  const char* path = argc>2 ? argv[2] : getenv("ACE_TABLEFILE");
+	  if (!path)
+	  {
+		 fprintf(stderr, "usage: speed_test -t table-file (or set ACE_TABLEFILE)\n");
+		 return 1;
+	  }
+	  return timeTable(path);
+	}
+#endif
+
+//`speed_test N` times LOTS of evals on N threads
+	if (argc>1)
+	{
+	  char* end;
+	  nthreads = strtol(argv[1], &end, 10);
+	  if (*end || nthreads<1)
+	  {
+		 fprintf(stderr, "usage: speed_test [threads | -s | -t table-file]\n");
+		 return 1;
+	  }
+	}
+
+	hands = malloc(sizeof(Card[ACEHAND])*LOTS);
+	if (!hands)
+	{
+		printf("Need %lu MB for the hands\n", (unsigned long)(sizeof(Card[ACEHAND])*LOTS>>20));
+		return 1;
 	}
+	dealHands(hands, LOTS, Deck, &cardsLeft);
+
+
+#ifdef ACE_DISPATCH
+	printf("compress: %s\n", E_compress());
+#endif
 
+//TIME LOTS of Evals, on `speed_test N` threads if asked
+	if (nthreads)
+	  return timeThreads(nthreads);
 
-//TIME LOTS of Evals
 	count = 0;
 	clock_t timer = clock();						    // start regular clock
 	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &timings); //and h-p clock
 
-	for (i=0;i<LOTS;i++)
-	{
-	  Card r = ACE_evaluate( hands[i] );
-	  handTypeSum[ACE_rank(r)]++;
-	  count++;
-	}
+	count = evalHands(0, LOTS, handTypeSum);
 
 	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &endtimings);	  // end the high precision clock
 	timer = clock() - timer;				  // end the regular clock
@@ -132,4 +410,14 @@ int main(int argc, char*argv[])
 
 	 printf("\n %lf Mhands/sec\n",count/((double)clocksused/1000)/1000000.0);
 
+#ifdef ACE_INLINE
+	int inlineSum[10]={0};
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &timings);
+	count = evalHandsInline(0, LOTS, inlineSum);
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &endtimings);
+	double inlineused = platformSysTimeToMs(platformTimeElapsed(endtimings,timings));
+	printf(" %lf Mhands/sec inline%s\n",count/(inlineused/1000)/1000000.0,
+			 memcmp(inlineSum,handTypeSum,sizeof(inlineSum)) ? " (WRONG hand types)" : "");
+#endif
+
 }